@@ -136,7 +136,7 @@ void life106_read_file_memory(const char* filename, cell* field){
 
 		// skip coordinate if it is outside the field
 		if (y < 0 || y >= field->height || x < 0 || x >= field->width) continue;
-		setCell(*field, x, y);
+		setCell(field, x, y);
 	}
 
 	free(file_content);
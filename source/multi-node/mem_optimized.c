@@ -10,6 +10,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mpi.h>
 
 /* User defined headers */
@@ -71,45 +72,71 @@ void deleteCell(cell* Cell, unsigned int x, unsigned int y) {
     _helperCell(*Cell, x, y, decrease_neighbor);
 }
 
-void nextGeneration(cell* Cell, cell* pCell, int mode, MPI_Comm MPI_COMM_NODE) {
+/*
+* A tile can only change if a cell in it or in one of its neighbour tiles
+* flipped last generation; columns wrap around the torus. The first and last
+* tile row of a stripe are always scanned, because the halo rows change
+* their border rows without a flip of this rank.
+*/
+static void activeTiles(cell* pCell, unsigned int ty) {
 
-    int x, y, count, w_diff, w_diff_0, h_diff;
-    int h0 = pCell->height_0;
-    int w0 = pCell->width_0;
-    int h = pCell->height;
-    int w = pCell->width;     
-    unsigned char* cell_ptr;
+    unsigned int tx, nx = pCell->tiles_x, ny = pCell->tiles_y;
+    const unsigned char* above = pCell->tiles + (ty - 1) * nx;
+    const unsigned char* middle = pCell->tiles + ty * nx;
+    const unsigned char* below = pCell->tiles + (ty + 1) * nx;
+    unsigned char* column = pCell->tile_active + nx;
 
-    w_diff = Cell->width - pCell->width;
-    w_diff_0 = Cell->width - pCell->width_0; // 0 - x : immer negativ? bzw. wird immer zu 0 in unserem Beispiel
-    h_diff = Cell->height - pCell->height;
+    if (ty == 0 || ty == ny - 1) {
+        memset(pCell->tile_active, 1, nx);
+        return;
+    }
 
-    memcpy(Cell->temp_ptr, Cell->ptr, Cell->size);
+    for (tx = 0; tx < nx; tx++) {
+        column[tx] = (above[tx] | middle[tx] | below[tx]) & TILE_CHANGED;
+    }
+
+    for (tx = 0; tx < nx; tx++) {
+        pCell->tile_active[tx] = column[(tx == 0) ? nx - 1 : tx - 1] | column[tx] | column[(tx == nx - 1) ? 0 : tx + 1];
+    }
+}
+
+/*
+* Scan row y of the snapshot in temp_ptr over the active tiles of the
+* stripe and write the flips into ptr.
+*/
+void scanStripeRow(cell* Cell, cell* pCell, int y) {
+
+    int x, x_end, count;
+    int w0 = pCell->width_0, w = pCell->width;
+    unsigned int tx, run, ty = (y - pCell->height_0) >> TILE_SHIFT;
+    unsigned char* row = Cell->temp_ptr + y * Cell->width;
+    unsigned char* tile_row = pCell->tiles + ty * pCell->tiles_x;
+
+    if (((y - pCell->height_0) & (TILE_SIZE - 1)) == 0) activeTiles(pCell, ty);
+
+    // Scan runs of active tiles, stable tiles are passed over
+    for (tx = 0; tx < pCell->tiles_x; tx = run) {
+
+        if (!pCell->tile_active[tx]) {
+            run = tx + 1;
+            continue;
+        }
+        for (run = tx + 1; run < pCell->tiles_x && pCell->tile_active[run]; run++);
+        x_end = (w0 + (int)(run << TILE_SHIFT) < w) ? w0 + (int)(run << TILE_SHIFT) : w;
+
+        for (x = w0 + (int)(tx << TILE_SHIFT); x < x_end; x++) {
 
-    if (mode == 1) MPI_Barrier(MPI_COMM_NODE);
-    
-    cell_ptr = Cell->temp_ptr;
-    cell_ptr += (h0 * Cell->width); // wenn Anfangswert von y != 0 muss ptr erst noch verschoben werden
-    cell_ptr += w0; 
-    
-    for (y = h0; y <= h; y++) {
- 
-        x = w0; // x = 0;
-        do {
             // Zero bytes are off and have no neighbours so skip them...
-            while (*cell_ptr == 0) {
-                cell_ptr++; // Advance to the next cell
-                // If all cells in row are off with no neighbours go to next row
-                if (++x >= w) goto RowDone;
-            }
-            
+            if (row[x] == 0) continue;
+
             // Remaining cells are either on or have neighbours
-            count = *cell_ptr >> 1; // # of neighboring on-cells
-            if (*cell_ptr & 0x01) {
+            count = row[x] >> 1; // # of neighboring on-cells
+            if (row[x] & 0x01) {
 
                 // On cell must turn off if not 2 or 3 neighbours
                 if ((count != 2) && (count != 3)) {
                     deleteCell(Cell, x, y);
+                    tile_row[(x - w0) >> TILE_SHIFT] |= TILE_NEXT;
                 }
             }
             else {
@@ -117,16 +144,47 @@ void nextGeneration(cell* Cell, cell* pCell, int mode, MPI_Comm MPI_COMM_NODE) {
                 // Off cell must turn on if 3 neighbours
                 if (count == 3) {
                     setCell(Cell, x, y);
+                    tile_row[(x - w0) >> TILE_SHIFT] |= TILE_NEXT;
                 }
             }
-            // Advance to the next cell byte
-            cell_ptr++;
-        } while (++x < w);
-    RowDone:;
-    cell_ptr += w_diff + w0;     // wenn w von 0 -> kleiner w luft UND wenn w von xyz -> w_ende luft
+        }
+    }
+}
+
+// Snapshot of the stripe rows in temp_ptr, the only rows this rank scans
+void snapshotStripe(cell* Cell, cell* pCell) {
+
+    size_t offset = (size_t)pCell->height_0 * Cell->width;
+    size_t size = (size_t)(pCell->height - pCell->height_0 + 1) * Cell->width;
+
+    memcpy(Cell->temp_ptr + offset, Cell->ptr + offset, size);
+}
+
+// TILE_NEXT becomes TILE_CHANGED for the next generation
+void ageTiles(cell* pCell) {
+
+    for (unsigned int i = 0; i < pCell->tiles_x * pCell->tiles_y; i++) {
+        pCell->tiles[i] >>= 1;
     }
 }
 
+void nextGeneration(cell* Cell, cell* pCell, int mode, MPI_Comm MPI_COMM_NODE) {
+
+    int y;
+    int h0 = pCell->height_0;
+    int h = pCell->height;
+
+    snapshotStripe(Cell, pCell);
+
+    if (mode == 1) MPI_Barrier(MPI_COMM_NODE);
+    
+    for (y = h0; y <= h; y++) {
+        scanStripeRow(Cell, pCell, y);
+    }
+
+    ageTiles(pCell);
+}
+
 unsigned int seed;
 void fillMap(cell* Cell, unsigned int w, unsigned int h) {
     unsigned int x, y, init_length;
@@ -212,6 +270,13 @@ cell createMapObject(cell map, unsigned int* rank, unsigned int* process_count)
 
     if (*rank == *process_count - 1) pmap.height = map.height - 1;
 
+    // Every tile of the stripe takes part in the first generation
+    pmap.tiles_x = (pmap.width - pmap.width_0 + TILE_SIZE - 1) >> TILE_SHIFT;
+    pmap.tiles_y = (pmap.height - pmap.height_0 + TILE_SIZE) >> TILE_SHIFT;
+    pmap.tiles = (unsigned char*)xmalloc(pmap.tiles_x * pmap.tiles_y);
+    pmap.tile_active = (unsigned char*)xmalloc(2 * pmap.tiles_x);
+    memset(pmap.tiles, TILE_CHANGED, pmap.tiles_x * pmap.tiles_y);
+
     return pmap;
 }
 
@@ -2,6 +2,12 @@
 
 #include <mpi.h>
 
+// Tiles of TILE_SIZE x TILE_SIZE cells; flags of the tile map
+#define TILE_SHIFT      6
+#define TILE_SIZE       (1 << TILE_SHIFT)
+#define TILE_CHANGED    0x01    // a cell of the tile flipped last generation
+#define TILE_NEXT       0x02    // a cell of the tile flipped this generation
+
 // =================================================
 //
 //                  STRUCTURES
@@ -16,6 +22,10 @@ typedef struct {
     unsigned int size;
     unsigned char* ptr;
     unsigned char* temp_ptr;
+    unsigned int tiles_x;       // tiles of the stripe, set by createMapObject
+    unsigned int tiles_y;
+    unsigned char* tiles;       // TILE_CHANGED / TILE_NEXT per tile
+    unsigned char* tile_active; // tiles to scan in the current tile row
 } cell;
 
 // =================================================
@@ -28,4 +38,9 @@ void GameMPI(cell map, cell pmap, int mode, MPI_Comm MPI_COMM_NODE);
 void GameMap_Release(cell map);
 cell GameMap_Init_Shrd(char* rptr, unsigned width, unsigned height, char* input_field_filename);
 cell GameMap_Init_Distr(unsigned width, unsigned height, char* input_field_filename);
-cell createMapObject(cell map, unsigned int* rank, unsigned int* process_count);
\ No newline at end of file
+cell createMapObject(cell map, unsigned int* rank, unsigned int* process_count);
+void setCell(cell* Cell, unsigned int x, unsigned int y);
+void deleteCell(cell* Cell, unsigned int x, unsigned int y);
+void scanStripeRow(cell* Cell, cell* pCell, int y);
+void snapshotStripe(cell* Cell, cell* pCell);
+void ageTiles(cell* pCell);
\ No newline at end of file
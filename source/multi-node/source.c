@@ -408,6 +408,8 @@ int main(int argc, char** argv) {
 	}
 
 	MPI_Win_free(&shwin);
+	free(pm.tiles);
+	free(pm.tile_active);
 	MPI_Finalize();
 	return 0;
 }
@@ -0,0 +1,53 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Cycle detection: the hash of every generation is remembered, once a
+* field repeats with period p the remaining frames are reduced modulo p.
+*
+* Referenzen:
+* Zobrist hashing: https://www.chessprogramming.org/Zobrist_Hashing
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* User defined headers */
+#include "cycle.h"
+#include "mem_optimized.h"
+
+void Cycle_Init(cycle_history* history) {
+
+    history->slots = (cycle_slot*)xmalloc(CYCLE_HISTORY * sizeof(cycle_slot));
+    memset(history->slots, 0, CYCLE_HISTORY * sizeof(cycle_slot));
+    history->period = 0;
+}
+
+void Cycle_Release(cycle_history* history) {
+    free(history->slots);
+}
+
+/*
+* Record the hash of generation and return the frame count to run to:
+* if the same field was seen at generation m, the field at frames equals
+* the one at generation + (frames - generation) mod (generation - m).
+*/
+unsigned int Cycle_Skip(cycle_history* history, uint64_t hash, unsigned int generation, unsigned int frames) {
+
+    cycle_slot* slot = history->slots + (hash & (CYCLE_HISTORY - 1));
+
+    if (history->period != 0) return frames;
+
+    if (slot->generation != 0 && slot->hash == hash) {
+        history->period = generation - (slot->generation - 1);
+        return generation + (frames - generation) % history->period;
+    }
+
+    slot->hash = hash;
+    slot->generation = generation + 1;
+
+    return frames;
+}
@@ -12,6 +12,8 @@
 #include "mem_optimized.h"
 #include "latency_hiding.h"
 #include "export.h"
+#include "cycle.h"
+#include "options.h"
 
 #define NELEMS(x)  (sizeof(x) / sizeof((x)[0]))
 
@@ -33,8 +35,8 @@ void DistrMemory(unsigned w, unsigned h, unsigned frames, char* input_field_file
 	int field_size[1];
 	// int recv_temp;
 
-	double start_time;
-	double end_time;
+	double start_time = 0;
+	double end_time = 0;
 	double duration;
 	double data[1];
 	size_t array_size;
@@ -72,6 +74,12 @@ void DistrMemory(unsigned w, unsigned h, unsigned frames, char* input_field_file
 	prev_rank = (rank == 0) ? process_count - 1 : rank - 1;
 	post_rank = (rank == (process_count - 1)) ? 0 : rank + 1;
 
+	// A dead edge sends nothing across: the first and last rank skip the wrap exchange
+	if (gameOptions.boundary == BOUNDARY_DEAD) {
+		if (rank == 0) prev_rank = MPI_PROC_NULL;
+		if (rank == process_count - 1) post_rank = MPI_PROC_NULL;
+	}
+
 	top_row = (pm.ptr + (pm.width * pm.height_0));
 	bot_row = (pm.ptr + (pm.width * pm.height ));
 
@@ -79,20 +87,33 @@ void DistrMemory(unsigned w, unsigned h, unsigned frames, char* input_field_file
 	halo_bot =  (pm.height + 1) >= m.height ? m.ptr : (pm.ptr + (pm.width * (pm.height + 1)));
 
 	double comm_start, comm_end;
-	double calc_start, calc_end;
+	double calc_start = 0, calc_end;
 	double comm_time = 0, calc_time = 0;
 	double* comm_time_ptr = &comm_time;
 	double* calc_time_ptr = &calc_time;
 
 	double mem = 0;
 	double* ptr_mem = &mem;
+
+	cycle_history history;
+	uint64_t stripe_hash = 0, hash = 0;
+	unsigned int last_frame = frames;
 	
 	if (rank == 0) start_time = MPI_Wtime();
+
+	// Every rank hashes its own stripe, the XOR of all stripes is the field
+	if (gameOptions.cycle) {
+		Cycle_Init(&history);
+		pm.hash = &stripe_hash;
+		stripe_hash = stripeHash(&m, &pm);
+		MPI_Allreduce(&stripe_hash, &hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+		last_frame = Cycle_Skip(&history, hash, 0, last_frame);
+	}
 	
-	for (unsigned int lo = 0; lo < frames; lo++) {
+	for (unsigned int lo = 0; lo < last_frame; lo++) {
 
-		memset(halo_top, 0, m.width);
-		memset(halo_bot, 0, m.width);
+		if (prev_rank != MPI_PROC_NULL) memset(halo_top, 0, m.width);
+		if (post_rank != MPI_PROC_NULL) memset(halo_bot, 0, m.width);
 
 		if (rank == 0) calc_start = MPI_Wtime();
 		GameMPI(m, pm, 0, ptr_mem); // start game in distributed mode
@@ -112,8 +133,18 @@ void DistrMemory(unsigned w, unsigned h, unsigned frames, char* input_field_file
 		comm_end = MPI_Wtime();
 		comm_time += (comm_end - comm_start);
 
-		mergeRows(bot_row, recv_buffer_top, pm.width);
-		mergeRows(top_row, recv_buffer_bot, pm.width);
+		if (post_rank != MPI_PROC_NULL) mergeRows(bot_row, recv_buffer_top, pm.width);
+		if (prev_rank != MPI_PROC_NULL) mergeRows(top_row, recv_buffer_bot, pm.width);
+
+		if (gameOptions.cycle) {
+			MPI_Allreduce(&stripe_hash, &hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+			last_frame = Cycle_Skip(&history, hash, lo + 1, last_frame);
+		}
+	}
+
+	if (gameOptions.cycle) {
+		if (rank == 0 && history.period) printf("// Cycle of period %u, stopped after %u generations\n", history.period, last_frame);
+		Cycle_Release(&history);
 	}
 	
 	// =================================================
@@ -142,6 +173,8 @@ void DistrMemory(unsigned w, unsigned h, unsigned frames, char* input_field_file
 
 	free(m.ptr);
 	free(m.temp_ptr);
+	free(pm.tiles);
+	free(pm.tile_active);
 	free(recv_buffer_bot);
 	free(recv_buffer_top);
 	
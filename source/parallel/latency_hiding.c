@@ -58,25 +58,14 @@ void nextGenerationLatencyHiding(cell* Cell, cell* pCell, int mode, double* comm
     memset(recv_buffer_top, 0, pCell->width);
     memset(recv_buffer_bot, 0, pCell->width);
 
-    int x, y, count, w_diff, w_diff_0, h_diff;
+    int y;
     int h0 = pCell->height_0;
-    int w0 = pCell->width_0;
     int h = pCell->height;
-    int w = pCell->width;
-    unsigned char* cell_ptr;
 
-    w_diff = Cell->width - pCell->width;
-    w_diff_0 = Cell->width - pCell->width_0; // 0 - x : immer negativ? bzw. wird immer zu 0 in unserem Beispiel
-    h_diff = Cell->height - pCell->height;
-
-    memcpy(Cell->temp_ptr, Cell->ptr, Cell->size);
+    snapshotStripe(Cell, pCell);
 
     if (mode == 1) MPI_Barrier(MPI_COMM_WORLD);
 
-    cell_ptr = Cell->temp_ptr;
-    cell_ptr += (h0 * Cell->width); // wenn Anfangswert von y != 0 muss ptr erst noch verschoben werden
-    cell_ptr += w0;
-
     MPI_Request request1;
     MPI_Request request2;
     MPI_Request request_send;
@@ -92,36 +81,7 @@ void nextGenerationLatencyHiding(cell* Cell, cell* pCell, int mode, double* comm
         
         if (rank == 0) calc_start = MPI_Wtime();
 
-        x = w0; // x = 0;
-        do {
-            // Zero bytes are off and have no neighbours so skip them...
-            while (*cell_ptr == 0) {
-                cell_ptr++; // Advance to the next cell
-                // If all cells in row are off with no neighbours go to next row
-                if (++x >= w) goto RowDone;
-            }
-
-            // Remaining cells are either on or have neighbours
-            count = *cell_ptr >> 1; // # of neighboring on-cells
-            if (*cell_ptr & 0x01) {
-
-                // On cell must turn off if not 2 or 3 neighbours
-                if ((count != 2) && (count != 3)) {
-                    deleteCell(Cell, x, y);
-                }
-            }
-            else {
-
-                // Off cell must turn on if 3 neighbours
-                if (count == 3) {
-                    setCell(Cell, x, y);
-                }
-            }
-            // Advance to the next cell byte
-            cell_ptr++;
-        } while (++x < w);
-        RowDone:;
-        cell_ptr += w_diff + w0;     // wenn w von 0 -> kleiner w luft UND wenn w von xyz -> w_ende luft
+        scanStripeRow(Cell, pCell, y);
 
         if (rank == 0) {
             calc_end = MPI_Wtime();
@@ -150,6 +110,8 @@ void nextGenerationLatencyHiding(cell* Cell, cell* pCell, int mode, double* comm
             mergeRowsLatencyHiding(top_row, recv_buffer_bot, pCell->width);
         }       
     } 
+
+    ageTiles(pCell);
 }
 
 // =================================================
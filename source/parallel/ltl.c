@@ -0,0 +1,348 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 08.05.2021
+*
+* Larger-than-Life on the MPI stripes: every rank keeps its stripe with r
+* halo rows above and below. The column sums over 2r + 1 rows slide down
+* the stripe, each row then takes its neighbourhood counts from a prefix
+* sum over the wrapped column sums. Both steps cost O(1) per cell, no
+* matter how large the range is. -boundary only changes the halos and the
+* ends of the prefix sum.
+*
+* Referenzen:
+* Larger than Life: https://conwaylife.com/wiki/Larger_than_Life
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <mpi.h>
+
+/* User defined headers */
+#include "ltl.h"
+#include "mem_optimized.h"
+#include "life106.h"
+#include "export.h"
+#include "cycle.h"
+#include "options.h"
+#include "utils.h"
+
+#define NELEMS(x)  (sizeof(x) / sizeof((x)[0]))
+
+// "min..max", returns the end of the range or NULL
+static const char* parseLtlRange(const char* text, unsigned int* min, unsigned int* max) {
+
+    char* end;
+
+    *min = (unsigned int)strtoul(text, &end, 10);
+    if (end == text || end[0] != '.' || end[1] != '.') return NULL;
+
+    text = end + 2;
+    *max = (unsigned int)strtoul(text, &end, 10);
+    if (end == text || *min > *max) return NULL;
+
+    return end;
+}
+
+// Returns 0 unless text holds R, S and B and only two-state Moore rules
+int parseLtlRule(const char* text, ltl_rule* rule) {
+
+    char* end;
+    const char* next;
+    unsigned long value;
+    int seen = 0;
+
+    rule->middle = 0;
+
+    while (*text != '\0') {
+
+        switch (toupper((unsigned char)*text++)) {
+        case 'R':
+            value = strtoul(text, &end, 10);
+            if (end == text || value == 0) return 0;
+            rule->range = (unsigned int)value;
+            next = end;
+            seen |= 1;
+            break;
+        case 'C':
+            // C0 and C2 both mean two states, more states would decay
+            value = strtoul(text, &end, 10);
+            if (end == text || value == 1 || value > 2) return 0;
+            next = end;
+            break;
+        case 'M':
+            value = strtoul(text, &end, 10);
+            if (end == text || value > 1) return 0;
+            rule->middle = (int)value;
+            next = end;
+            break;
+        case 'S':
+            next = parseLtlRange(text, &rule->survive_min, &rule->survive_max);
+            seen |= 2;
+            break;
+        case 'B':
+            next = parseLtlRange(text, &rule->birth_min, &rule->birth_max);
+            seen |= 4;
+            break;
+        case 'N':
+            // Moore neighbourhood only
+            next = (toupper((unsigned char)*text) == 'M') ? text + 1 : NULL;
+            break;
+        default:
+            return 0;
+        }
+
+        if (next == NULL) return 0;
+        text = next;
+        if (*text == ',') text++;
+        else if (*text != '\0') return 0;
+    }
+
+    return seen == 7;
+}
+
+/*
+* Halo rows: the first r rows of the stripe go to the previous rank and
+* come back from the next one as the bottom halo, the last r rows the
+* other way round. A single rank exchanges with itself.
+*/
+static void exchangeHalos(unsigned char* cells, unsigned int w, unsigned int rows, unsigned int r, int prev_rank, int post_rank) {
+
+    int count = (int)(r * w);
+
+    MPI_Sendrecv(cells + (size_t)r * w, count, MPI_UNSIGNED_CHAR, prev_rank, 0,
+        cells + (size_t)(r + rows) * w, count, MPI_UNSIGNED_CHAR, post_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    MPI_Sendrecv(cells + (size_t)rows * w, count, MPI_UNSIGNED_CHAR, post_rank, 1,
+        cells, count, MPI_UNSIGNED_CHAR, prev_rank, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+// Klein bottle: halo rows from across the top or bottom edge come back mirrored
+static void mirrorRows(unsigned char* rows, unsigned int w, unsigned int count) {
+
+    unsigned char* row;
+    unsigned char temp;
+
+    for (unsigned int k = 0; k < count; k++) {
+        row = rows + (size_t)k * w;
+        for (unsigned int x = 0; x < w / 2; x++) {
+            temp = row[x];
+            row[x] = row[w - 1 - x];
+            row[w - 1 - x] = temp;
+        }
+    }
+}
+
+/*
+* Next generation of the rows r .. r + rows - 1 of cells into next. column
+* and prefix hold w and w + 2r + 1 counters. Returns the hash of the live
+* cells of the stripe, 0 unless -cycle is set. A dead edge leaves the
+* columns beyond the left and right edge out of the prefix sum.
+*/
+static uint64_t ltlStep(const ltl_rule* rule, const unsigned char* cells, unsigned char* next, unsigned int w, unsigned int rows,
+    unsigned int y_0, unsigned int* column, unsigned int* prefix, int boundary) {
+
+    unsigned int r = rule->range, span = 2 * r + 1;
+    unsigned int i, k, x, src, count;
+    const unsigned char* row;
+    uint64_t hash = 0;
+
+    // Column sums of the rows -r .. r around the first row of the stripe
+    memset(column, 0, w * sizeof(unsigned int));
+    for (k = 0; k < span; k++) {
+        row = cells + (size_t)k * w;
+        for (x = 0; x < w; x++) column[x] += row[x];
+    }
+
+    for (i = 0; i < rows; i++) {
+
+        unsigned char* out = next + (size_t)(i + r) * w;
+
+        row = cells + (size_t)(i + r) * w;
+
+        // Slide the window one row down
+        if (i > 0) {
+            const unsigned char* enter = cells + (size_t)(i + span - 1) * w;
+            const unsigned char* leave = cells + (size_t)(i - 1) * w;
+            for (x = 0; x < w; x++) column[x] += enter[x] - leave[x];
+        }
+
+        // prefix[k] sums the column sums of the columns -r .. k - r - 1
+        prefix[0] = 0;
+        if (boundary == BOUNDARY_DEAD) {
+            for (k = 0; k < w + 2 * r; k++) {
+                prefix[k + 1] = prefix[k] + ((k >= r && k < r + w) ? column[k - r] : 0);
+            }
+        }
+        else {
+            src = (w - r % w) % w;
+            for (k = 0; k < w + 2 * r; k++) {
+                prefix[k + 1] = prefix[k] + column[src];
+                if (++src == w) src = 0;
+            }
+        }
+
+        for (x = 0; x < w; x++) {
+
+            count = prefix[x + span] - prefix[x];
+            if (!rule->middle) count -= row[x];
+
+            out[x] = row[x]
+                ? (count >= rule->survive_min && count <= rule->survive_max)
+                : (count >= rule->birth_min && count <= rule->birth_max);
+
+            if (gameOptions.cycle && out[x]) hash ^= cycleKey(x, y_0 + i, w);
+        }
+    }
+
+    return hash;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+void LargerThanLife(unsigned w, unsigned h, unsigned frames, char* input_field_filename, char* output_field_filename, char* folder_name) {
+
+    int process_count;
+    int rank;
+    int prev_rank;
+    int post_rank;
+    int field_size[1];
+
+    double start_time = 0;
+    double end_time = 0;
+    double duration;
+    double data[1];
+
+    unsigned int r, rows, y, x;
+    unsigned int min_rows;
+    unsigned int* column;
+    unsigned int* prefix;
+    unsigned char* cells;
+    unsigned char* next;
+    unsigned char* temp;
+    int* counts = NULL;
+    int* displs = NULL;
+
+    ltl_rule rule;
+    cell m;
+    cell pm;
+
+    cycle_history history;
+    uint64_t stripe_hash = 0, hash = 0;
+    unsigned int last_frame = frames;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    if (!parseLtlRule(gameOptions.ltl ? gameOptions.ltl : LTL_BOSCO, &rule)) error("Invalid Larger than Life rule! Expected e.g. R5,C2,M1,S34..58,B34..45,NM");
+
+    // The same stripes as the count map, every halo comes from one rank
+    m = GameMap_Init_Distr(w, h, input_field_filename);
+    pm = createMapObject(m, (unsigned int*)&rank, (unsigned int*)&process_count);
+    free(pm.tiles);
+    free(pm.tile_active);
+
+    r = rule.range;
+    rows = pm.height - pm.height_0 + 1;
+    min_rows = (m.size / process_count) / m.width;
+    if (min_rows < r) error("Every stripe needs at least as many rows as the range!");
+
+    cells = (unsigned char*)xmalloc((size_t)(rows + 2 * r) * w);
+    next = (unsigned char*)xmalloc((size_t)(rows + 2 * r) * w);
+    column = (unsigned int*)xmalloc(w * sizeof(unsigned int));
+    prefix = (unsigned int*)xmalloc((w + 2 * r + 1) * sizeof(unsigned int));
+    memset(cells, 0, (size_t)(rows + 2 * r) * w);
+    memset(next, 0, (size_t)(rows + 2 * r) * w);
+
+    for (y = 0; y < rows; y++) {
+        for (x = 0; x < w; x++) {
+            cells[(size_t)(y + r) * w + x] = m.ptr[(size_t)(pm.height_0 + y) * w + x] & 0x01;
+            if (gameOptions.cycle && cells[(size_t)(y + r) * w + x]) stripe_hash ^= cycleKey(x, pm.height_0 + y, w);
+        }
+    }
+
+    prev_rank = (rank == 0) ? process_count - 1 : rank - 1;
+    post_rank = (rank == (process_count - 1)) ? 0 : rank + 1;
+
+    // Without wrap the halos beyond the edge stay dead
+    if (gameOptions.boundary == BOUNDARY_DEAD) {
+        if (rank == 0) prev_rank = MPI_PROC_NULL;
+        if (rank == process_count - 1) post_rank = MPI_PROC_NULL;
+    }
+
+    if (rank == 0) start_time = MPI_Wtime();
+
+    if (gameOptions.cycle) {
+        Cycle_Init(&history);
+        MPI_Allreduce(&stripe_hash, &hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+        last_frame = Cycle_Skip(&history, hash, 0, last_frame);
+    }
+
+    for (unsigned int i = 0; i < last_frame; i++) {
+
+        exchangeHalos(cells, w, rows, r, prev_rank, post_rank);
+        if (gameOptions.boundary == BOUNDARY_KLEIN) {
+            if (rank == 0) mirrorRows(cells, w, r);
+            if (rank == process_count - 1) mirrorRows(cells + (size_t)(r + rows) * w, w, r);
+        }
+        stripe_hash = ltlStep(&rule, cells, next, w, rows, pm.height_0, column, prefix, gameOptions.boundary);
+
+        temp = cells;
+        cells = next;
+        next = temp;
+
+        if (gameOptions.cycle) {
+            MPI_Allreduce(&stripe_hash, &hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+            last_frame = Cycle_Skip(&history, hash, i + 1, last_frame);
+        }
+    }
+
+    if (gameOptions.cycle) {
+        if (rank == 0 && history.period) printf("// Cycle of period %u, stopped after %u generations\n", history.period, last_frame);
+        Cycle_Release(&history);
+    }
+
+    // =================================================
+    //
+    //                  Merge Image
+    //
+    // =================================================
+    if (rank == 0) {
+        counts = (int*)xmalloc(process_count * sizeof(int));
+        displs = (int*)xmalloc(process_count * sizeof(int));
+    }
+
+    int count = (int)(rows * w);
+    int displ = (int)(pm.height_0 * w);
+
+    MPI_Gather(&count, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Gather(&displ, 1, MPI_INT, displs, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Gatherv(cells + (size_t)r * w, count, MPI_UNSIGNED_CHAR, m.ptr, counts, displs, MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        end_time = MPI_Wtime();
+        life106_save_file_memory(output_field_filename, &m);
+        free(counts);
+        free(displs);
+    }
+
+    free(cells);
+    free(next);
+    free(column);
+    free(prefix);
+    GameMap_Release(m);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    duration = end_time - start_time;
+    data[0] = duration;
+    field_size[0] = w;
+    exportJson("ltl", data, NELEMS(data), field_size, process_count, frames, folder_name);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+/*
+* Larger-than-Life rule in Golly notation, e.g. R5,C2,M1,S34..58,B34..45,NM
+* for Bosco's rule. The neighbourhood is the (2r + 1) x (2r + 1) square
+* around a cell, the cell itself counts when middle is set. A dead cell is
+* born with birth_min..birth_max live cells in it, a live cell survives
+* with survive_min..survive_max.
+*/
+typedef struct {
+    unsigned int range;
+    int middle;
+    unsigned int birth_min;
+    unsigned int birth_max;
+    unsigned int survive_min;
+    unsigned int survive_max;
+} ltl_rule;
+
+#define LTL_BOSCO   "R5,C2,M1,S34..58,B34..45,NM"   // rule of mode 3 without -ltl
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+int parseLtlRule(const char* text, ltl_rule* rule);
+void LargerThanLife(unsigned w, unsigned h, unsigned frames, char* input_field_filename, char* output_field_filename, char* folder_name);
@@ -8,11 +8,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mpi.h>
 
 /* User defined headers */
 #include "mem_optimized.h"
 #include "life106.h"
+#include "cycle.h"
+#include "rule.h"
+#include "options.h"
 
 void* xmalloc(size_t bytes) {
 
@@ -25,19 +29,29 @@ void* xmalloc(size_t bytes) {
     return buffer;
 }
 
-void _helperCell(cell Cell, unsigned int x, unsigned int y, signed int neighbor) {
+// Add neighbor to the cells x - 1, x and x + 1 of row, wrapped unless the edge is dead
+static inline void addRow(unsigned char* row, int x, int w, signed int neighbor, const int boundary) {
+
+    if (x > 0) row[x - 1] += neighbor;
+    else if (boundary != BOUNDARY_DEAD) row[w - 1] += neighbor;
+
+    row[x] += neighbor;
 
-    int w = Cell.width, h = Cell.height, size = Cell.size;
-    int xoleft, xoright, yoabove, yobelow;
-    int offset = (y * w) + x;
-    unsigned char* cell_ptr = Cell.ptr + offset;
+    if (x < w - 1) row[x + 1] += neighbor;
+    else if (boundary != BOUNDARY_DEAD) row[0] += neighbor;
+}
 
-    // Calculate the offsets to the eight neighboring cells,
-    // accounting for wrapping around at the edges of the cell map
-    xoleft = (x == 0) ? w - 1 : -1;
-    xoright = (x == (w - 1)) ? -(w - 1) : 1;
-    yoabove = (y == 0) ? size - w : -w;
-    yobelow = (y == (h - 1)) ? -(size - w) : w;
+/*
+* Flip the cell and change the counts of its eight neighbours. boundary is
+* a constant in every caller, so only its own branches are left: the torus
+* wraps both ways, the Klein bottle comes back with x mirrored across the
+* top and bottom edge, and a dead edge has no neighbours beyond it.
+*/
+static inline void helperCellBoundary(cell Cell, unsigned int x, unsigned int y, signed int neighbor, const int boundary) {
+
+    int w = Cell.width, h = Cell.height;
+    unsigned char* row = Cell.ptr + (y * w);
+    unsigned char* cell_ptr = row + x;
 
     if (neighbor < 0) {
         *(cell_ptr) &= ~0x01;   // Set first bit to 0
@@ -46,15 +60,32 @@ void _helperCell(cell Cell, unsigned int x, unsigned int y, signed int neighbor)
         *(cell_ptr) |= 0x01;    // Set first bit to 1
     }
 
-    // Change successive bits for neighbour counts
-    *(cell_ptr + yoabove + xoleft) += neighbor;
-    *(cell_ptr + yoabove) += neighbor;
-    *(cell_ptr + yoabove + xoright) += neighbor;
-    *(cell_ptr + xoleft) += neighbor;
-    *(cell_ptr + xoright) += neighbor;
-    *(cell_ptr + yobelow + xoleft) += neighbor;
-    *(cell_ptr + yobelow) += neighbor;
-    *(cell_ptr + yobelow + xoright) += neighbor;
+    // Row above
+    if (y > 0) addRow(row - w, x, w, neighbor, boundary);
+    else if (boundary == BOUNDARY_TORUS) addRow(Cell.ptr + (h - 1) * w, x, w, neighbor, boundary);
+    else if (boundary == BOUNDARY_KLEIN) addRow(Cell.ptr + (h - 1) * w, w - 1 - x, w, neighbor, boundary);
+
+    // Left and right neighbour
+    if (x > 0) *(cell_ptr - 1) += neighbor;
+    else if (boundary != BOUNDARY_DEAD) row[w - 1] += neighbor;
+
+    if ((int)x < w - 1) *(cell_ptr + 1) += neighbor;
+    else if (boundary != BOUNDARY_DEAD) row[0] += neighbor;
+
+    // Row below
+    if ((int)y < h - 1) addRow(row + w, x, w, neighbor, boundary);
+    else if (boundary == BOUNDARY_TORUS) addRow(Cell.ptr, x, w, neighbor, boundary);
+    else if (boundary == BOUNDARY_KLEIN) addRow(Cell.ptr, w - 1 - x, w, neighbor, boundary);
+}
+
+// Boundary of gameOptions, chosen by selectStripeRule
+static int stripeBoundary = BOUNDARY_TORUS;
+
+void _helperCell(cell Cell, unsigned int x, unsigned int y, signed int neighbor) {
+
+    if (stripeBoundary == BOUNDARY_DEAD) helperCellBoundary(Cell, x, y, neighbor, BOUNDARY_DEAD);
+    else if (stripeBoundary == BOUNDARY_KLEIN) helperCellBoundary(Cell, x, y, neighbor, BOUNDARY_KLEIN);
+    else helperCellBoundary(Cell, x, y, neighbor, BOUNDARY_TORUS);
 }
 
 void setCell(cell* Cell, unsigned int x, unsigned int y) {
@@ -69,22 +100,178 @@ void deleteCell(cell* Cell, unsigned int x, unsigned int y) {
     _helperCell(*Cell, x, y, decrease_neighbor);
 }
 
+/*
+* A tile can only change if a cell in it or in one of its neighbour tiles
+* flipped last generation; columns wrap around the torus. The first and last
+* tile row of a stripe are always scanned, because the halo rows change
+* their border rows without a flip of this rank.
+*/
+static void activeTiles(cell* pCell, unsigned int ty) {
+
+    unsigned int tx, nx = pCell->tiles_x, ny = pCell->tiles_y;
+    const unsigned char* above = pCell->tiles + (ty - 1) * nx;
+    const unsigned char* middle = pCell->tiles + ty * nx;
+    const unsigned char* below = pCell->tiles + (ty + 1) * nx;
+    unsigned char* column = pCell->tile_active + nx;
+
+    if (ty == 0 || ty == ny - 1) {
+        memset(pCell->tile_active, 1, nx);
+        return;
+    }
+
+    for (tx = 0; tx < nx; tx++) {
+        column[tx] = (above[tx] | middle[tx] | below[tx]) & TILE_CHANGED;
+    }
+
+    for (tx = 0; tx < nx; tx++) {
+        pCell->tile_active[tx] = column[(tx == 0) ? nx - 1 : tx - 1] | column[tx] | column[(tx == nx - 1) ? 0 : tx + 1];
+    }
+}
+
+/*
+* Scan row y of the snapshot in temp_ptr over the active tiles of the
+* stripe and write the flips into ptr. flips is the RULE_FLIPS mask of
+* the rule, boundary the BOUNDARY_* of the field.
+*/
+static inline void scanStripeRowRule(cell* Cell, cell* pCell, int y, const uint32_t flips, const int boundary) {
+
+    int x, x_end;
+    int w0 = pCell->width_0, w = pCell->width;
+    unsigned int tx, run, ty = (y - pCell->height_0) >> TILE_SHIFT;
+    unsigned char* row = Cell->temp_ptr + y * Cell->width;
+    unsigned char* tile_row = pCell->tiles + ty * pCell->tiles_x;
+
+    if (((y - pCell->height_0) & (TILE_SIZE - 1)) == 0) activeTiles(pCell, ty);
+
+    // Scan runs of active tiles, stable tiles are passed over
+    for (tx = 0; tx < pCell->tiles_x; tx = run) {
+
+        if (!pCell->tile_active[tx]) {
+            run = tx + 1;
+            continue;
+        }
+        for (run = tx + 1; run < pCell->tiles_x && pCell->tile_active[run]; run++);
+        x_end = (w0 + (int)(run << TILE_SHIFT) < w) ? w0 + (int)(run << TILE_SHIFT) : w;
+
+        for (x = w0 + (int)(tx << TILE_SHIFT); x < x_end; x++) {
+
+            // Zero bytes are off and have no neighbours so skip them...
+            if (row[x] == 0) continue;
+
+            // Remaining cells are either on or have neighbours, state and
+            // count together select the bit of the flip mask
+            if ((flips >> row[x]) & 1) {
+                helperCellBoundary(*Cell, x, y, (row[x] & 0x01) ? -0x02 : 0x02, boundary);
+                tile_row[(x - w0) >> TILE_SHIFT] |= TILE_NEXT;
+                if (pCell->hash) *pCell->hash ^= cycleKey(x, y, Cell->width);
+            }
+        }
+    }
+}
+
+typedef void (*stripe_row_fn)(cell* Cell, cell* pCell, int y);
+
+#define STRIPE_ROW_RULE(id, text, birth, survive) \
+    static void scanStripeRowTorus##id(cell* Cell, cell* pCell, int y) { \
+        scanStripeRowRule(Cell, pCell, y, RULE_FLIPS(birth, survive), BOUNDARY_TORUS); \
+    } \
+    static void scanStripeRowDead##id(cell* Cell, cell* pCell, int y) { \
+        scanStripeRowRule(Cell, pCell, y, RULE_FLIPS(birth, survive), BOUNDARY_DEAD); \
+    } \
+    static void scanStripeRowKlein##id(cell* Cell, cell* pCell, int y) { \
+        scanStripeRowRule(Cell, pCell, y, RULE_FLIPS(birth, survive), BOUNDARY_KLEIN); \
+    }
+#define STRIPE_ROW_TORUS(id, text, birth, survive) scanStripeRowTorus##id,
+#define STRIPE_ROW_DEAD(id, text, birth, survive) scanStripeRowDead##id,
+#define STRIPE_ROW_KLEIN(id, text, birth, survive) scanStripeRowKlein##id,
+
+LIFE_RULES(STRIPE_ROW_RULE)
+
+// Indexed by boundary, then by the position in LIFE_RULES
+static const stripe_row_fn stripeRowKernels[BOUNDARY_COUNT][RULE_TABLE_SIZE] = {
+    { LIFE_RULES(STRIPE_ROW_TORUS) },
+    { LIFE_RULES(STRIPE_ROW_DEAD) },
+    { LIFE_RULES(STRIPE_ROW_KLEIN) },
+};
+
+static uint32_t customFlips;
+
+static void scanStripeRowTorusCustom(cell* Cell, cell* pCell, int y) {
+    scanStripeRowRule(Cell, pCell, y, customFlips, BOUNDARY_TORUS);
+}
+
+static void scanStripeRowDeadCustom(cell* Cell, cell* pCell, int y) {
+    scanStripeRowRule(Cell, pCell, y, customFlips, BOUNDARY_DEAD);
+}
+
+static void scanStripeRowKleinCustom(cell* Cell, cell* pCell, int y) {
+    scanStripeRowRule(Cell, pCell, y, customFlips, BOUNDARY_KLEIN);
+}
+
+static const stripe_row_fn stripeRowCustom[BOUNDARY_COUNT] = { scanStripeRowTorusCustom, scanStripeRowDeadCustom, scanStripeRowKleinCustom };
+
+static stripe_row_fn stripeRowKernel = scanStripeRowTorusLife;
+
+// Pick the row kernel of rule and boundary, called once before the field is read
+void selectStripeRule(const life_rule* rule, int boundary) {
+
+    int index = ruleIndex(rule);
+
+    customFlips = RULE_FLIPS(rule->birth, rule->survive);
+    stripeBoundary = boundary;
+    stripeRowKernel = (index == RULE_CUSTOM) ? stripeRowCustom[boundary] : stripeRowKernels[boundary][index];
+}
+
+void scanStripeRow(cell* Cell, cell* pCell, int y) {
+    stripeRowKernel(Cell, pCell, y);
+}
+
+// Hash of the live cells of the stripe, the ranks XOR theirs together
+uint64_t stripeHash(cell* Cell, cell* pCell) {
+
+    uint64_t hash = 0;
+    unsigned char* row;
+
+    for (unsigned int y = pCell->height_0; y <= pCell->height; y++) {
+        row = Cell->ptr + y * Cell->width;
+        for (unsigned int x = 0; x < Cell->width; x++) {
+            if (row[x] & 0x01) hash ^= cycleKey(x, y, Cell->width);
+        }
+    }
+
+    return hash;
+}
+
+/*
+* Copy the rows of this stripe into temp_ptr before a generation. Only
+* they are scanned, so only they need a snapshot; the rest of temp_ptr is
+* never read by this rank.
+*/
+void snapshotStripe(cell* Cell, cell* pCell) {
+
+    size_t offset = (size_t)pCell->height_0 * Cell->width;
+    size_t size = (size_t)(pCell->height - pCell->height_0 + 1) * Cell->width;
+
+    memcpy(Cell->temp_ptr + offset, Cell->ptr + offset, size);
+}
+
+// TILE_NEXT becomes TILE_CHANGED for the next generation
+void ageTiles(cell* pCell) {
+
+    for (unsigned int i = 0; i < pCell->tiles_x * pCell->tiles_y; i++) {
+        pCell->tiles[i] >>= 1;
+    }
+}
+
 void nextGeneration(cell* Cell, cell* pCell, int mode, double* ptr_mem) {
 
-    int x, y, count, w_diff, w_diff_0, h_diff;
+    int y;
     int h0 = pCell->height_0;
-    int w0 = pCell->width_0;
     int h = pCell->height;
-    int w = pCell->width;     
-    unsigned char* cell_ptr;
-
-    w_diff = Cell->width - pCell->width;
-    w_diff_0 = Cell->width - pCell->width_0; // 0 - x : immer negativ? bzw. wird immer zu 0 in unserem Beispiel
-    h_diff = Cell->height - pCell->height;
 
     double start_time, end_time, duration;
     start_time = MPI_Wtime();
-    memcpy(Cell->temp_ptr, Cell->ptr, Cell->size);
+    snapshotStripe(Cell, pCell);
     end_time = MPI_Wtime();
 
     int rank;
@@ -96,43 +283,11 @@ void nextGeneration(cell* Cell, cell* pCell, int mode, double* ptr_mem) {
 
     if (mode == 1) MPI_Barrier(MPI_COMM_WORLD);
     
-    cell_ptr = Cell->temp_ptr;
-    cell_ptr += (h0 * Cell->width); // wenn Anfangswert von y != 0 muss ptr erst noch verschoben werden
-    cell_ptr += w0; 
-    
     for (y = h0; y <= h; y++) {
- 
-        x = w0; // x = 0;
-        do {
-            // Zero bytes are off and have no neighbours so skip them...
-            while (*cell_ptr == 0) {
-                cell_ptr++; // Advance to the next cell
-                // If all cells in row are off with no neighbours go to next row
-                if (++x >= w) goto RowDone;
-            }
-            
-            // Remaining cells are either on or have neighbours
-            count = *cell_ptr >> 1; // # of neighboring on-cells
-            if (*cell_ptr & 0x01) {
-
-                // On cell must turn off if not 2 or 3 neighbours
-                if ((count != 2) && (count != 3)) {
-                    deleteCell(Cell, x, y);
-                }
-            }
-            else {
-
-                // Off cell must turn on if 3 neighbours
-                if (count == 3) {
-                    setCell(Cell, x, y);
-                }
-            }
-            // Advance to the next cell byte
-            cell_ptr++;
-        } while (++x < w);
-    RowDone:;
-    cell_ptr += w_diff + w0;     // wenn w von 0 -> kleiner w luft UND wenn w von xyz -> w_ende luft
+        scanStripeRow(Cell, pCell, y);
     }
+
+    ageTiles(pCell);
 }
 
 unsigned int seed;
@@ -220,6 +375,14 @@ cell createMapObject(cell map, unsigned int* rank, unsigned int* process_count)
 
     if (*rank == *process_count - 1) pmap.height = map.height - 1;
 
+    // Every tile of the stripe takes part in the first generation
+    pmap.tiles_x = (pmap.width - pmap.width_0 + TILE_SIZE - 1) >> TILE_SHIFT;
+    pmap.tiles_y = (pmap.height - pmap.height_0 + TILE_SIZE) >> TILE_SHIFT;
+    pmap.tiles = (unsigned char*)xmalloc(pmap.tiles_x * pmap.tiles_y);
+    pmap.tile_active = (unsigned char*)xmalloc(2 * pmap.tiles_x);
+    memset(pmap.tiles, TILE_CHANGED, pmap.tiles_x * pmap.tiles_y);
+    pmap.hash = NULL;
+
     return pmap;
 }
 
@@ -0,0 +1,32 @@
+#include "options.h"
+#include "utils.h"
+
+#include <stddef.h>
+#include <string.h>
+
+game_options gameOptions = { 0, { "Life", RULE_LIFE_BIRTH, RULE_LIFE_SURVIVE }, BOUNDARY_TORUS, NULL };
+
+void parseOptions(int argc, char** argv, int first)
+{
+	for (int i = first; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-cycle") == 0) gameOptions.cycle = 1;
+		else if (strcmp(argv[i], "-rule") == 0 && i + 1 < argc)
+		{
+			if (!parseRule(argv[++i], &gameOptions.rule)) error("Invalid rule! Expected B/S notation, e.g. B36/S23");
+
+			// A cell without neighbours would be born, the empty field would not stay empty
+			if (gameOptions.rule.birth & 0x001) error("B0 rules are not supported!");
+		}
+		else if (strcmp(argv[i], "-ltl") == 0 && i + 1 < argc) gameOptions.ltl = argv[++i];
+		else if (strcmp(argv[i], "-boundary") == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], "torus") == 0) gameOptions.boundary = BOUNDARY_TORUS;
+			else if (strcmp(argv[i], "dead") == 0) gameOptions.boundary = BOUNDARY_DEAD;
+			else if (strcmp(argv[i], "klein") == 0) gameOptions.boundary = BOUNDARY_KLEIN;
+			else error("Unknown boundary! Boundaries: torus, dead, klein");
+		}
+		else error("Unknown option! Options: -cycle, -rule <Bxx/Syy>, -boundary <torus|dead|klein>, -ltl <Rr,Cc,Mm,Smin..max,Bmin..max,NM>");
+	}
+}
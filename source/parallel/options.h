@@ -0,0 +1,33 @@
+#pragma once
+
+#include "rule.h"
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+// -boundary: what lies beyond the edge of the field
+#define BOUNDARY_TORUS  0       // the opposite edge
+#define BOUNDARY_DEAD   1       // dead cells
+#define BOUNDARY_KLEIN  2       // left and right as torus, top and bottom joined with x mirrored
+#define BOUNDARY_COUNT  3
+
+// Optional flags behind the positional arguments
+typedef struct {
+    int cycle;      // -cycle: detect a repeating field and skip to the last frame
+    life_rule rule; // -rule Bxx/Syy, B3/S23 by default
+    int boundary;   // -boundary torus|dead|klein, torus by default
+    const char* ltl; // -ltl <rule>: Larger than Life rule of mode 3, NULL for Bosco's rule
+} game_options;
+
+extern game_options gameOptions;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+void parseOptions(int argc, char** argv, int first);
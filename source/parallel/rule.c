@@ -0,0 +1,67 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Rulestrings in B/S notation, e.g. B36/S23 for HighLife. The digits after
+* B are the neighbour counts that bring a dead cell to life, the digits
+* after S those that keep a live cell alive.
+*
+* Referenzen:
+* Rulestring: https://conwaylife.com/wiki/Rulestring
+*********************************************************************/
+
+#include <ctype.h>
+
+/* User defined headers */
+#include "rule.h"
+
+#define RULE_ENTRY(id, text, birth, survive) { #id, birth, survive },
+
+static const life_rule lifeRules[] = { LIFE_RULES(RULE_ENTRY) };
+
+// Digits 0..8 up to the next '/' or the end, each at most once
+static const char* parseCounts(const char* text, uint16_t* mask) {
+
+    *mask = 0;
+
+    for (; *text >= '0' && *text <= '8'; text++) {
+        if (*mask & (1u << (*text - '0'))) return NULL;
+        *mask |= (uint16_t)(1u << (*text - '0'));
+    }
+
+    return text;
+}
+
+// Returns 0 if text is not a B/S rulestring
+int parseRule(const char* text, life_rule* rule) {
+
+    int index;
+
+    if (toupper((unsigned char)*text++) != 'B') return 0;
+    text = parseCounts(text, &rule->birth);
+    if (text == NULL || *text++ != '/') return 0;
+    if (toupper((unsigned char)*text++) != 'S') return 0;
+    text = parseCounts(text, &rule->survive);
+    if (text == NULL || *text != '\0') return 0;
+
+    index = ruleIndex(rule);
+    rule->name = (index == RULE_CUSTOM) ? "Custom" : lifeRules[index].name;
+
+    return 1;
+}
+
+// Position of the rule in LIFE_RULES, the order of every kernel table
+int ruleIndex(const life_rule* rule) {
+
+    for (int i = 0; i < (int)(sizeof(lifeRules) / sizeof(lifeRules[0])); i++) {
+        if (lifeRules[i].birth == rule->birth && lifeRules[i].survive == rule->survive) return i;
+    }
+
+    return RULE_CUSTOM;
+}
+
+int ruleIsLife(const life_rule* rule) {
+    return rule->birth == RULE_LIFE_BIRTH && rule->survive == RULE_LIFE_SURVIVE;
+}
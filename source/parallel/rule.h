@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+/*
+* Outer-totalistic rule: bit n of birth is set when a dead cell with n live
+* neighbours comes alive, bit n of survive when a live one stays alive.
+*/
+typedef struct {
+    const char* name;
+    uint16_t birth;
+    uint16_t survive;
+} life_rule;
+
+/*
+* Rules with kernels of their own: identifier, rulestring, birth, survive.
+* The engines expand this list into one specialised function per rule, so
+* the masks end up as constants in the inner loops. Any other rulestring
+* runs on a generic kernel that reads the masks at run time.
+*/
+#define LIFE_RULES(X) \
+    X(Life,             "B3/S23",           0x008, 0x00C) \
+    X(HighLife,         "B36/S23",          0x048, 0x00C) \
+    X(DayAndNight,      "B3678/S34678",     0x1C8, 0x1D8) \
+    X(Seeds,            "B2/S",             0x004, 0x000) \
+    X(LifeWithoutDeath, "B3/S012345678",    0x008, 0x1FF) \
+    X(Replicator,       "B1357/S1357",      0x0AA, 0x0AA) \
+    X(TwoByTwo,         "B36/S125",         0x048, 0x026) \
+    X(Morley,           "B368/S245",        0x148, 0x034) \
+    X(Maze,             "B3/S12345",        0x008, 0x03E) \
+    X(Diamoeba,         "B35678/S5678",     0x1E8, 0x1E0)
+
+// Number of entries in LIFE_RULES, the length of every kernel table
+#define RULE_ONE(id, text, birth, survive) + 1
+#define RULE_TABLE_SIZE     (0 LIFE_RULES(RULE_ONE))
+
+#define RULE_LIFE_BIRTH     0x008
+#define RULE_LIFE_SURVIVE   0x00C
+#define RULE_CUSTOM         -1      // ruleIndex of a rule outside LIFE_RULES
+
+// Bit n of a neighbour mask moves to bit 2n
+#define RULE_SPREAD(m) \
+    (((m) & 0x001) | (((m) & 0x002) << 1) | (((m) & 0x004) << 2) | \
+    (((m) & 0x008) << 3) | (((m) & 0x010) << 4) | (((m) & 0x020) << 5) | \
+    (((m) & 0x040) << 6) | (((m) & 0x080) << 7) | (((m) & 0x100) << 8))
+
+/*
+* Flip mask over the count-map byte (state | neighbours << 1): bit b is set
+* when a cell holding byte b changes state in the next generation.
+*/
+#define RULE_FLIPS(birth, survive) \
+    ((uint32_t)RULE_SPREAD(birth) | ((uint32_t)RULE_SPREAD(~(survive) & 0x1FF) << 1))
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+int parseRule(const char* text, life_rule* rule);
+int ruleIndex(const life_rule* rule);
+int ruleIsLife(const life_rule* rule);
@@ -12,6 +12,8 @@
 
 /* User defined headers */
 #include "mem_optimized.h"
+#include "cycle.h"
+#include "options.h"
 
 #define NELEMS(x)  (sizeof(x) / sizeof((x)[0]))
 
@@ -193,21 +195,35 @@ void SharedMemory(unsigned w, unsigned h, unsigned frames, char* input_field_fil
 	double comm_start, comm_end;
 	double calc_start, calc_end;
 	double comm_time = 0, calc_time = 0;
+	double mem = 0;
+
+	cycle_history history;
+	uint64_t stripe_hash = 0, hash = 0;
+	unsigned int last_frame = frames;
 
 	if (rank == 0) start_time = MPI_Wtime();
 
-	for (int lo = 0; lo < frames; lo++) {
+	// Every rank hashes its own stripe, the XOR of all stripes is the field
+	if (gameOptions.cycle) {
+		Cycle_Init(&history);
+		pm.hash = &stripe_hash;
+		stripe_hash = stripeHash(&m, &pm);
+		MPI_Allreduce(&stripe_hash, &hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+		last_frame = Cycle_Skip(&history, hash, 0, last_frame);
+	}
+
+	for (unsigned int lo = 0; lo < last_frame; lo++) {
 
 		if (rank == 0) {
 			calc_start = MPI_Wtime();
 			MPI_Win_sync(shwin);
-			GameMPI(m, pm, 1);		// start game in shared mode
+			GameMPI(m, pm, 1, &mem);		// start game in shared mode
 			calc_end = MPI_Wtime();
 			calc_time += (calc_end - calc_start);
 		}
 
 		if (rank != 0) {
-			GameMPI(m, pm, 1);		// start game in shared mode
+			GameMPI(m, pm, 1, &mem);		// start game in shared mode
 			MPI_Win_sync(shwin);
 		}
 
@@ -220,6 +236,16 @@ void SharedMemory(unsigned w, unsigned h, unsigned frames, char* input_field_fil
 		MPI_Barrier(MPI_COMM_WORLD);
 		comm_end = MPI_Wtime();
 		comm_time += (comm_end - comm_start);
+
+		if (gameOptions.cycle) {
+			MPI_Allreduce(&stripe_hash, &hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+			last_frame = Cycle_Skip(&history, hash, lo + 1, last_frame);
+		}
+	}
+
+	if (gameOptions.cycle) {
+		if (rank == 0 && history.period) printf("// Cycle of period %u, stopped after %u generations\n", history.period, last_frame);
+		Cycle_Release(&history);
 	}
 
 	if (rank == 0) { 
@@ -228,6 +254,8 @@ void SharedMemory(unsigned w, unsigned h, unsigned frames, char* input_field_fil
 	}
 
 	MPI_Win_free(&shwin);
+	free(pm.tiles);
+	free(pm.tile_active);
 
 	double comm_data[1] = { comm_time };
 	double calc_data[1] = { calc_time };
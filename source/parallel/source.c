@@ -35,17 +35,19 @@
 #include "mem_optimized.h"
 #include "shared_mem.h"
 #include "distr_mem.h"
+#include "ltl.h"
+#include "options.h"
 #include "utils.h"
 
 #define NELEMS(x)  (sizeof(x) / sizeof((x)[0]))
 
 int main(int argc, char** argv) {
-	if (argc != 9) error("Arguments: <height> <width> <frames> <input.lif> <output1.lif> <output2.lif> <mode> <new_folder_name>");
+	if (argc < 9) error("Arguments: <height> <width> <frames> <input.lif> <output1.lif> <output2.lif> <mode> <new_folder_name> [-cycle] [-rule <Bxx/Syy>] [-boundary <torus|dead|klein>] [-ltl <rule>]");
 	
 	int process_count;
 	int rank;
 	int field_size[1];
-	int mode;			// 0: both, 1: shared, 2: distributed
+	int mode;			// 0: both, 1: shared, 2: distributed, 3: larger than life (distributed)
 
 	double start_time;
 	double end_time;
@@ -75,11 +77,17 @@ int main(int argc, char** argv) {
 	// export_filename2 = argv[8];
 	mode = atoi(argv[7]);
 	folder_name = argv[8];
+	parseOptions(argc, argv, 9);
+	selectStripeRule(&gameOptions.rule, gameOptions.boundary);
 
 	if (height <= 0) error("Height must be a positive number!");
 	if (width <= 0) error("Width must be a positive number!");
 	if (frames <= 0) error("Frames must be a positive number!");
 
+	// Larger than Life has its own rule, the count map stripes have no other
+	if (!ruleIsLife(&gameOptions.rule) && mode == 3) error("Mode 3 takes its rule from -ltl, not -rule!");
+	if (gameOptions.ltl != NULL && mode != 3) error("Only mode 3 supports -ltl!");
+
 	MPI_Init(&argc, &argv);
 	MPI_Comm_size(MPI_COMM_WORLD, &process_count);
 	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -139,6 +147,36 @@ int main(int argc, char** argv) {
 
 		DistrMemory(width, height, frames, input_field_filename, output_field_filename2, folder_name);
 	}
+
+	// =================================================
+	// 
+	//				LARGER THAN LIFE
+	// 
+	// =================================================
+	if (mode == 3) {
+		if (rank == 0) {
+			printf("// ================================\n"
+				"//\n"
+				"//	Running Larger than Life ...\n"
+				"//	Threads		: %i\n"
+				"//	Frames		: %i\n"
+				"//	Field		: %ix%i\n"
+				"//	Rule		: %s\n"
+				"//	Input  file	: %s\n"
+				"//	Output file	: %s\n"
+				"//\n"
+				"// ================================\n",
+				process_count,
+				frames,
+				height,
+				width,
+				gameOptions.ltl ? gameOptions.ltl : LTL_BOSCO,
+				input_field_filename,
+				output_field_filename2);
+		}
+
+		LargerThanLife(width, height, frames, input_field_filename, output_field_filename2, folder_name);
+	}
 	MPI_Finalize();
 	
 	return 0;
@@ -2,43 +2,196 @@
 #include "field.h"
 #include "life106.h"
 #include "utils.h"
+#include "options.h"
+#include "rule.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BASELINE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 void show(field_t* field)
 {
 	printf("\033[H");
 	for_i(y, field->height)
 	{
-		for_i(x, field->width) printf(field->rows[y][x] ? "\033[07m  \033[m" : "  ");
+		for_i(x, field->width) printf(field_row(field, y)[x] ? "\033[07m  \033[m" : "  ");
 		printf("\033[E");
 	}
 	fflush(stdout);
 }
 
-void evolve(field_t** field_pointer)
+typedef void (*evolve_fn)(field_t* field);
+
+/*
+* Reference kernel for any rule and boundary. It is expanded once per entry
+* of LIFE_RULES and per boundary below, so masks and boundary are constants
+* in every expansion and the boundary tests fold away.
+*/
+static inline void evolve_rule(field_t* field, unsigned birth, unsigned survive, int boundary)
 {
-	field_t* field = *field_pointer;
-	field_t* new_field = field_new(field->height, field->width);
-	if (new_field == NULL) error("Can't allocate new field!");
+	int w = (int)field->width, h = (int)field->height;
 
 	for_yx(field->height, field->width)
 	{
 		int n = 0;
-		for (int y1 = y - 1; y1 <= y + 1; y1++)
-			for (int x1 = x - 1; x1 <= x + 1; x1++)
-				if (field->rows[(y1 + field->height) % field->height][(x1 + field->width) % field->width])
+		for (int y1 = (int)y - 1; y1 <= (int)y + 1; y1++)
+			for (int x1 = (int)x - 1; x1 <= (int)x + 1; x1++)
+			{
+				int xx = x1, yy = y1;
+
+				if (boundary == BOUNDARY_DEAD)
+				{
+					if (xx < 0 || xx >= w || yy < 0 || yy >= h) continue;
+				}
+				else if (boundary == BOUNDARY_KLEIN && (yy < 0 || yy >= h))
+				{
+					// across the top or bottom edge the field comes back mirrored
+					xx = w - 1 - xx;
+				}
+
+				if (field_row(field, (yy + h) % h)[(xx + w) % w])
 					n++;
+			}
 
-		if (field->rows[y][x]) n--;
-		new_field->rows[y][x] = (n == 3 || (n == 2 && field->rows[y][x]));
+		unsigned char alive = field_row(field, y)[x];
+		if (alive) n--;
+		field_back_row(field, y)[x] = ((alive ? survive : birth) >> n) & 1;
 	}
 
-	*field_pointer = new_field;
-	field_delete(field);
+	field_swap(field);
+}
+
+#define EVOLVE_RULE(id, text, birth, survive) \
+	static void evolve_torus_##id(field_t* field) { evolve_rule(field, birth, survive, BOUNDARY_TORUS); } \
+	static void evolve_dead_##id(field_t* field) { evolve_rule(field, birth, survive, BOUNDARY_DEAD); } \
+	static void evolve_klein_##id(field_t* field) { evolve_rule(field, birth, survive, BOUNDARY_KLEIN); }
+#define EVOLVE_TORUS(id, text, birth, survive) evolve_torus_##id,
+#define EVOLVE_DEAD(id, text, birth, survive) evolve_dead_##id,
+#define EVOLVE_KLEIN(id, text, birth, survive) evolve_klein_##id,
+
+LIFE_RULES(EVOLVE_RULE)
+
+// Indexed by boundary, then by the position in LIFE_RULES
+static const evolve_fn evolve_kernels[BOUNDARY_COUNT][RULE_TABLE_SIZE] = {
+	{ LIFE_RULES(EVOLVE_TORUS) },
+	{ LIFE_RULES(EVOLVE_DEAD) },
+	{ LIFE_RULES(EVOLVE_KLEIN) },
+};
+
+static void evolve_custom_torus(field_t* field)
+{
+	evolve_rule(field, gameOptions.rule.birth, gameOptions.rule.survive, BOUNDARY_TORUS);
+}
+
+static void evolve_custom_dead(field_t* field)
+{
+	evolve_rule(field, gameOptions.rule.birth, gameOptions.rule.survive, BOUNDARY_DEAD);
+}
+
+static void evolve_custom_klein(field_t* field)
+{
+	evolve_rule(field, gameOptions.rule.birth, gameOptions.rule.survive, BOUNDARY_KLEIN);
+}
+
+static const evolve_fn evolve_custom[BOUNDARY_COUNT] = { evolve_custom_torus, evolve_custom_dead, evolve_custom_klein };
+
+static evolve_fn evolve_select(const life_rule* rule, int boundary)
+{
+	int index = ruleIndex(rule);
+	return (index == RULE_CUSTOM) ? evolve_custom[boundary] : evolve_kernels[boundary][index];
+}
+
+void evolve(field_t* field)
+{
+	evolve_select(&gameOptions.rule, gameOptions.boundary)(field);
+}
+
+/*
+* Vertical pass: sum of the three rows for every column.
+*/
+static void column_sums(unsigned char* column, const unsigned char* above, const unsigned char* row, const unsigned char* below, unsigned width)
+{
+	unsigned x = 0;
+
+#ifdef BASELINE_SSE2
+	for (; x + 16 <= width; x += 16)
+	{
+		__m128i a = _mm_load_si128((const __m128i*)(above + x));
+		__m128i r = _mm_load_si128((const __m128i*)(row + x));
+		__m128i b = _mm_load_si128((const __m128i*)(below + x));
+		_mm_storeu_si128((__m128i*)(column + x), _mm_add_epi8(_mm_add_epi8(a, r), b));
+	}
+#endif
+
+	for (; x < width; x++) column[x] = above[x] + row[x] + below[x];
+}
+
+/*
+* Horizontal pass over the padded column sums. The sum includes the cell
+* itself, so 3 means birth or survival and 4 means survival of a live cell.
+*/
+static void apply_rule(unsigned char* out, const unsigned char* column, const unsigned char* row, unsigned width)
+{
+	unsigned x = 0;
+
+#ifdef BASELINE_SSE2
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i three = _mm_set1_epi8(3);
+	const __m128i four = _mm_set1_epi8(4);
+
+	for (; x + 16 <= width; x += 16)
+	{
+		__m128i left = _mm_loadu_si128((const __m128i*)(column + x));
+		__m128i mid = _mm_loadu_si128((const __m128i*)(column + x + 1));
+		__m128i right = _mm_loadu_si128((const __m128i*)(column + x + 2));
+		__m128i alive = _mm_load_si128((const __m128i*)(row + x));
+		__m128i n = _mm_add_epi8(_mm_add_epi8(left, mid), right);
+
+		__m128i next = _mm_or_si128(_mm_cmpeq_epi8(n, three),
+			_mm_and_si128(_mm_cmpeq_epi8(n, four), _mm_cmpeq_epi8(alive, one)));
+		_mm_store_si128((__m128i*)(out + x), _mm_and_si128(next, one));
+	}
+#endif
+
+	for (; x < width; x++)
+	{
+		unsigned n = column[x] + column[x + 1] + column[x + 2];
+		out[x] = (n == 3 || (n == 4 && row[x]));
+	}
+}
+
+/*
+* Same result as evolve, computed as separable column and row sums. The
+* torus only shows up in the choice of the neighbouring rows and in the two
+* padding cells of the column sums.
+*/
+void evolve_vectorized(field_t* field)
+{
+	unsigned width = field->width;
+	unsigned height = field->height;
+
+	// column sums with one padding cell on each side
+	unsigned char* column = field->sums;
+
+	for_i(y, height)
+	{
+		const unsigned char* above = field_row(field, (y == 0) ? height - 1 : y - 1);
+		const unsigned char* below = field_row(field, (y == height - 1) ? 0 : y + 1);
+
+		column_sums(column + 1, above, field_row(field, y), below, width);
+		column[0] = column[width];
+		column[width + 1] = column[1];
+
+		apply_rule(field_back_row(field, y), column, field_row(field, y), width);
+	}
+
+	field_swap(field);
 }
 
 double BaseGame(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename){
@@ -47,10 +200,33 @@ double BaseGame(unsigned width, unsigned height, unsigned frames, char* input_fi
 	if (field == NULL) error("Can't allocate field!");
 	life106_read_file(input_field_filename, field);
 
+	evolve_fn kernel = evolve_select(&gameOptions.rule, gameOptions.boundary);
+
+	clock_t start_time = clock();
+	for_i(i, frames)
+	{
+		kernel(field);
+	}
+	clock_t end_time = clock();
+
+	life106_save_file(output_field_filename, field);
+
+	field_delete(field);
+	field = NULL;
+
+	return (double)(end_time - start_time) / (double)CLOCKS_PER_SEC;
+}
+
+double BaseGameVectorized(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename){
+
+	field_t* field = field_new(height, width);
+	if (field == NULL) error("Can't allocate field!");
+	life106_read_file(input_field_filename, field);
+
 	clock_t start_time = clock();
 	for_i(i, frames)
 	{
-		evolve(&field);
+		evolve_vectorized(field);
 	}
 	clock_t end_time = clock();
 
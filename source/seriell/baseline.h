@@ -6,4 +6,5 @@
 // 
 // =================================================
 
-double BaseGame(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
\ No newline at end of file
+double BaseGame(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+double BaseGameVectorized(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
\ No newline at end of file
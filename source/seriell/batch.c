@@ -0,0 +1,252 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Bit-sliced batch: 64 boards of the same size share one map, lane i of
+* every word belongs to board i. The adder network of the bitboard then
+* advances a cell of all 64 boards at once, and the neighbours need no
+* shifts because they are whole words. Parameter sweeps over thousands of
+* small fields run in one process instead of one process per field.
+*
+* Referenzen:
+* Bitslicing: https://www.chessprogramming.org/General_Setwise_Operations
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "batch.h"
+#include "bitboard.h"
+#include "mem_optimized.h"
+#include "life106.h"
+#include "options.h"
+#include "file_utils.h"
+#include "string_utils.h"
+#include "utils.h"
+
+void Batch_Init(batch_map* map, unsigned width, unsigned height) {
+
+    size_t words = (size_t)(width + 2) * (height + 2);
+
+    map->width = width;
+    map->height = height;
+    map->stride = width + 2;
+    map->boards = 0;
+    map->cells = (uint64_t*)xmalloc(words * sizeof(uint64_t)) + map->stride + 1;
+    map->temp_cells = (uint64_t*)xmalloc(words * sizeof(uint64_t)) + map->stride + 1;
+
+    Batch_Clear(map);
+}
+
+void Batch_Release(batch_map* map) {
+    free(map->cells - map->stride - 1);
+    free(map->temp_cells - map->stride - 1);
+}
+
+// Every lane dead, ghost words included
+void Batch_Clear(batch_map* map) {
+
+    size_t words = (size_t)map->stride * (map->height + 2);
+
+    memset(map->cells - map->stride - 1, 0, words * sizeof(uint64_t));
+    memset(map->temp_cells - map->stride - 1, 0, words * sizeof(uint64_t));
+    map->boards = 0;
+}
+
+void Batch_SetCell(batch_map* map, unsigned int x, unsigned int y, unsigned int lane) {
+    map->cells[(size_t)y * map->stride + x] |= (uint64_t)1 << lane;
+}
+
+// Copy the opposite edges into the ghost words and rows
+static void wrapBatch(batch_map* map) {
+
+    unsigned int w = map->width, h = map->height, s = map->stride;
+    uint64_t* row;
+
+    for (unsigned int y = 0; y < h; y++) {
+        row = map->cells + (size_t)y * s;
+        row[-1] = row[w - 1];
+        row[w] = row[0];
+    }
+
+    memcpy(map->cells - s - 1, map->cells + (size_t)(h - 1) * s - 1, s * sizeof(uint64_t));
+    memcpy(map->cells + (size_t)h * s - 1, map->cells - 1, s * sizeof(uint64_t));
+}
+
+// =================================================
+//
+//                  RULE KERNELS
+//
+// =================================================
+
+// B3/S23 on the shorter adder network of lifeWord
+static void batchRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int width) {
+
+    // Signed, x - 1 reaches the ghost word at -1
+    for (int x = 0; x < (int)width; x++) {
+        out[x] = lifeWord(above[x - 1], above[x], above[x + 1],
+                          row[x - 1],   row[x],   row[x + 1],
+                          below[x - 1], below[x], below[x + 1]);
+    }
+}
+
+static inline void batchRowRule(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int width,
+                                unsigned int birth, unsigned int survive) {
+
+    for (int x = 0; x < (int)width; x++) {
+        out[x] = ruleWord(above[x - 1], above[x], above[x + 1],
+                          row[x - 1],   row[x],   row[x + 1],
+                          below[x - 1], below[x], below[x + 1],
+                          birth, survive);
+    }
+}
+
+#define BATCH_RULE_ROW(id, text, birth, survive) \
+    static void batchRow##id(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int width) { \
+        batchRowRule(above, row, below, out, width, birth, survive); \
+    }
+#define BATCH_RULE_ENTRY(id, text, birth, survive) batchRow##id,
+
+LIFE_RULES(BATCH_RULE_ROW)
+
+static const batch_row_fn batchRuleKernels[] = { LIFE_RULES(BATCH_RULE_ENTRY) };
+
+static unsigned int customBirth, customSurvive;
+
+static void batchRowCustom(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int width) {
+    batchRowRule(above, row, below, out, width, customBirth, customSurvive);
+}
+
+// Kernel of the rule in gameOptions, chosen by batchSelectRule
+static batch_row_fn batchRowKernel = batchRow;
+
+static void batchSelectRule(const life_rule* rule) {
+
+    int index = ruleIndex(rule);
+
+    customBirth = rule->birth;
+    customSurvive = rule->survive;
+
+    if (ruleIsLife(rule)) batchRowKernel = batchRow;
+    else batchRowKernel = (index == RULE_CUSTOM) ? batchRowCustom : batchRuleKernels[index];
+}
+
+void Batch_NextGeneration(batch_map* map) {
+
+    unsigned int s = map->stride;
+    uint64_t* temp;
+
+    wrapBatch(map);
+
+    for (unsigned int y = 0; y < map->height; y++) {
+        const uint64_t* row = map->cells + (size_t)y * s;
+        batchRowKernel(row - s, row, row + s, map->temp_cells + (size_t)y * s, map->width);
+    }
+
+    temp = map->cells;
+    map->cells = map->temp_cells;
+    map->temp_cells = temp;
+}
+
+// =================================================
+//
+//                  BOARD LIST
+//
+// =================================================
+
+/*
+* Paths of the boards, one Life 1.06 file per line, lines starting with
+* '#' are comments. The paths point into *content, which the caller frees.
+*/
+static unsigned int readBoardList(const char* filename, char** content, char*** paths) {
+
+    char** lines = NULL;
+    unsigned int lines_count, count = 0;
+
+    *content = read_file(filename);
+    lines_count = string_split(*content, "\r\n", &lines);
+
+    for (unsigned int i = 0; i < lines_count; i++) {
+        if (lines[i][0] != '#') lines[count++] = lines[i];
+    }
+
+    if (count == 0) error("The board list holds no Life 1.06 file!");
+
+    *paths = lines;
+    return count;
+}
+
+// <output without .lif>_NNNN.lif for board index
+static void boardFilename(char* name, size_t size, const char* output, unsigned int index) {
+
+    size_t length = strlen(output);
+
+    if (length >= 4 && strcmp(output + length - 4, ".lif") == 0) length -= 4;
+    sprintf_s(name, size, "%.*s_%04u.lif", (int)length, output, index);
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+/*
+* input_field_filename lists the boards, every board is written to its own
+* file next to output_field_filename. Only the generations are timed,
+* reading and writing the boards is not.
+*/
+double GameBatch(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    batch_map map;
+    char* content;
+    char** paths;
+    size_t name_size = strlen(output_field_filename) + 16;
+    char* name = (char*)xmalloc(name_size);
+    unsigned int count, first, lane;
+    clock_t start, elapsed = 0;
+    double seconds;
+
+    count = readBoardList(input_field_filename, &content, &paths);
+    batchSelectRule(&gameOptions.rule);
+    Batch_Init(&map, width, height);
+
+    for (first = 0; first < count; first += BATCH_LANES) {
+
+        Batch_Clear(&map);
+        map.boards = (count - first < BATCH_LANES) ? count - first : BATCH_LANES;
+
+        for (lane = 0; lane < map.boards; lane++) {
+            life106_read_file_batch(paths[first + lane], &map, lane);
+        }
+
+        start = clock();
+
+        for (unsigned int i = 0; i < frames; i++) {
+            Batch_NextGeneration(&map);
+        }
+
+        elapsed += clock() - start;
+
+        for (lane = 0; lane < map.boards; lane++) {
+            boardFilename(name, name_size, output_field_filename, first + lane);
+            life106_save_file_batch(name, &map, lane);
+        }
+    }
+
+    seconds = (double)elapsed / (double)CLOCKS_PER_SEC;
+    printf("// Batch: %u boards in %u batches, %.0f boards/s\n",
+        count, (count + BATCH_LANES - 1) / BATCH_LANES, (seconds > 0) ? count / seconds : 0.0);
+
+    Batch_Release(&map);
+    free(name);
+    free(paths);
+    free(content);
+
+    return seconds;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rule.h"
+
+// Boards per batch, one per bit of a word
+#define BATCH_LANES 64
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+/*
+* Bit-sliced boards: bit i of a word is the same cell of board i, so a
+* word holds one cell of 64 boards and the neighbour words are simply the
+* words around it. Rows carry a ghost word on both sides and the map a
+* ghost row above and below (stride = width + 2), the torus is copied
+* into them once per generation. cells points at cell (0, 0).
+*/
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    unsigned int stride;
+    unsigned int boards;        // lanes in use
+    uint64_t* cells;
+    uint64_t* temp_cells;
+} batch_map;
+
+typedef void (*batch_row_fn)(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int width);
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameBatch(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+void Batch_Init(batch_map* map, unsigned width, unsigned height);
+void Batch_Release(batch_map* map);
+void Batch_Clear(batch_map* map);
+void Batch_SetCell(batch_map* map, unsigned int x, unsigned int y, unsigned int lane);
+void Batch_NextGeneration(batch_map* map);
@@ -0,0 +1,176 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Referenzen:
+* Bitboard:   https://www.chessprogramming.org/General_Setwise_Operations
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "bitboard.h"
+#include "mem_optimized.h"
+#include "life106.h"
+
+bitboard_row_fn bitboardRowKernel = bitboardRow;
+
+// =================================================
+//
+//                  RULE KERNELS
+//
+// =================================================
+
+#define BITBOARD_RULE_ROW(id, text, birth, survive) \
+    static void bitboardRow##id(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask) { \
+        ruleWords(above, row, below, out, 1, words, birth, survive); \
+        out[words] &= last_mask; \
+    }
+#define BITBOARD_RULE_ENTRY(id, text, birth, survive) bitboardRow##id,
+
+LIFE_RULES(BITBOARD_RULE_ROW)
+
+static const bitboard_row_fn bitboardRuleKernels[] = { LIFE_RULES(BITBOARD_RULE_ENTRY) };
+
+static unsigned int customBirth, customSurvive;
+
+static void bitboardRowCustom(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask) {
+    ruleWords(above, row, below, out, 1, words, customBirth, customSurvive);
+    out[words] &= last_mask;
+}
+
+/*
+* Row kernel for a rule other than B3/S23, which keeps the vectorized
+* kernels of bitboardSelectKernel. Returns the name of the rule.
+*/
+const char* bitboardSelectRule(const life_rule* rule) {
+
+    int index = ruleIndex(rule);
+
+    customBirth = rule->birth;
+    customSurvive = rule->survive;
+    bitboardRowKernel = (index == RULE_CUSTOM) ? bitboardRowCustom : bitboardRuleKernels[index];
+
+    return rule->name;
+}
+
+bitmap BitMap_Init(unsigned width, unsigned height) {
+
+    bitmap map;
+    size_t bytes;
+
+    map.width = width;
+    map.height = height;
+    map.words = (width + 63) / 64;
+    map.stride = map.words + 2;
+    map.last_mask = (width & 63) ? (((uint64_t)1 << (width & 63)) - 1) : ~(uint64_t)0;
+
+    bytes = (size_t)map.stride * height * sizeof(uint64_t);
+    map.rows = (uint64_t*)xmalloc(bytes);
+    map.temp_rows = (uint64_t*)xmalloc(bytes);
+    memset(map.rows, 0, bytes);
+    memset(map.temp_rows, 0, bytes);
+
+    return map;
+}
+
+void BitMap_Release(bitmap map) {
+    free(map.rows);
+    free(map.temp_rows);
+}
+
+void setBit(bitmap map, unsigned int x, unsigned int y) {
+    *(map.rows + (size_t)y * map.stride + 1 + (x >> 6)) |= (uint64_t)1 << (x & 63);
+}
+
+int getBit(bitmap map, unsigned int x, unsigned int y) {
+    return (int)((*(map.rows + (size_t)y * map.stride + 1 + (x >> 6)) >> (x & 63)) & 1);
+}
+
+/*
+* Write the torus wrap into the ghost words of a row: bit position -1 holds
+* cell w-1 and bit position w (ghost word or spare bit of the last word)
+* holds cell 0. Everything else of the padding stays zero.
+*/
+void wrapRow(uint64_t* row, unsigned int width, unsigned int words) {
+
+    unsigned int last = width - 1;
+    uint64_t first_cell = row[1] & 1;
+    uint64_t last_cell = (row[1 + (last >> 6)] >> (last & 63)) & 1;
+
+    row[0] = last_cell << 63;
+    row[words + 1] = 0;
+
+    if ((width & 63) == 0) {
+        row[words + 1] = first_cell;
+    }
+    else {
+        row[words] &= ((uint64_t)1 << (width & 63)) - 1;
+        row[words] |= first_cell << (width & 63);
+    }
+}
+
+/*
+* Rows point at their left ghost word and must have been wrapped with wrapRow.
+*/
+void bitboardRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask) {
+
+    lifeWords(above, row, below, out, 1, words);
+    out[words] &= last_mask;
+}
+
+void nextGenerationBitboard(bitmap* map) {
+
+    unsigned int y;
+    unsigned int h = map->height, words = map->words, stride = map->stride;
+    uint64_t* rows = map->rows;
+    uint64_t* temp;
+
+    for (y = 0; y < h; y++) {
+        wrapRow(rows + (size_t)y * stride, map->width, words);
+    }
+
+    for (y = 0; y < h; y++) {
+
+        const uint64_t* above = rows + (size_t)((y == 0) ? h - 1 : y - 1) * stride;
+        const uint64_t* below = rows + (size_t)((y == h - 1) ? 0 : y + 1) * stride;
+
+        bitboardRowKernel(above, rows + (size_t)y * stride, below, map->temp_rows + (size_t)y * stride, words, map->last_mask);
+    }
+
+    temp = map->rows;
+    map->rows = map->temp_rows;
+    map->temp_rows = temp;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameBitboard(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    bitmap map = BitMap_Init(width, height);
+
+    life106_read_file_bitmap(input_field_filename, &map);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        nextGenerationBitboard(&map);
+    }
+
+    clock_t end = clock();
+
+    life106_save_file_bitmap(output_field_filename, &map);
+
+    BitMap_Release(map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "rule.h"
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+/*
+* One bit per cell, 64 cells per word. Every row carries a ghost word on
+* both sides (stride = words + 2) so that the torus wrap can be written
+* into the row once per generation instead of being tested per cell.
+*/
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    unsigned int words;         // 64-bit words per row
+    unsigned int stride;        // words + 2 ghost words
+    uint64_t last_mask;         // valid bits of the last word in a row
+    uint64_t* rows;
+    uint64_t* temp_rows;
+} bitmap;
+
+typedef void (*bitboard_row_fn)(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask);
+
+// Row kernel used by nextGenerationBitboard, chosen by bitboardSelectKernel
+extern bitboard_row_fn bitboardRowKernel;
+
+/*
+* Bit-parallel neighbour count for 64 cells. The eight neighbour words are
+* summed with full/half adders; only the twos column has to be evaluated
+* completely, the ones column decides between 2 and 3.
+*/
+static inline uint64_t lifeWord(uint64_t nw, uint64_t n, uint64_t ne,
+                                uint64_t w, uint64_t c, uint64_t e,
+                                uint64_t sw, uint64_t s, uint64_t se) {
+
+    uint64_t s1 = nw ^ n ^ ne, c1 = (nw & n) | (ne & (nw ^ n));
+    uint64_t s3 = sw ^ s ^ se, c3 = (sw & s) | (se & (sw ^ s));
+    uint64_t s2 = w ^ e, c2 = w & e;
+
+    // Ones column
+    uint64_t ones = s1 ^ s2 ^ s3;
+    uint64_t ca = (s1 & s2) | (s3 & (s1 ^ s2));
+
+    // Twos column: c1 + c2 + c3 + ca
+    uint64_t t = c1 ^ c2 ^ c3;
+    uint64_t tc = (c1 & c2) | (c3 & (c1 ^ c2));
+
+    // Exactly one "two" -> 2 or 3 neighbours, the ones column picks 3 or (2 and alive)
+    return (t ^ ca) & ~tc & (ones | c);
+}
+
+/*
+* Same adder network for any outer-totalistic rule: the neighbour count is
+* completed to four bit planes and compared against every count in birth
+* and survive. With constant masks only the terms of those counts remain.
+*/
+static inline uint64_t ruleWord(uint64_t nw, uint64_t n, uint64_t ne,
+                                uint64_t w, uint64_t c, uint64_t e,
+                                uint64_t sw, uint64_t s, uint64_t se,
+                                unsigned int birth, unsigned int survive) {
+
+    uint64_t s1 = nw ^ n ^ ne, c1 = (nw & n) | (ne & (nw ^ n));
+    uint64_t s3 = sw ^ s ^ se, c3 = (sw & s) | (se & (sw ^ s));
+    uint64_t s2 = w ^ e, c2 = w & e;
+
+    uint64_t ones = s1 ^ s2 ^ s3;
+    uint64_t ca = (s1 & s2) | (s3 & (s1 ^ s2));
+
+    uint64_t t = c1 ^ c2 ^ c3;
+    uint64_t tc = (c1 & c2) | (c3 & (c1 ^ c2));
+    uint64_t twos = t ^ ca, k = t & ca;
+    uint64_t fours = tc ^ k, eights = tc & k;
+
+    uint64_t born = 0, kept = 0, eq;
+
+    // Spelled out per count so every test folds away for constant masks
+#define RULE_COUNT(count) \
+    if (((birth | survive) >> (count)) & 1) { \
+        eq = (((count) & 1) ? ones : ~ones) & (((count) & 2) ? twos : ~twos) & \
+             (((count) & 4) ? fours : ~fours) & (((count) & 8) ? eights : ~eights); \
+        if ((birth >> (count)) & 1) born |= eq; \
+        if ((survive >> (count)) & 1) kept |= eq; \
+    }
+
+    RULE_COUNT(0) RULE_COUNT(1) RULE_COUNT(2) RULE_COUNT(3) RULE_COUNT(4)
+    RULE_COUNT(5) RULE_COUNT(6) RULE_COUNT(7) RULE_COUNT(8)
+#undef RULE_COUNT
+
+    return (born & ~c) | (kept & c);
+}
+
+// Scalar tail shared by the row kernels: words first..last (1-based, inclusive)
+static inline void lifeWords(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int first, unsigned int last) {
+
+    for (unsigned int i = first; i <= last; i++) {
+
+        uint64_t a = above[i], r = row[i], b = below[i];
+
+        out[i] = lifeWord(
+            (a << 1) | (above[i - 1] >> 63), a, (a >> 1) | (above[i + 1] << 63),
+            (r << 1) | (row[i - 1] >> 63),   r, (r >> 1) | (row[i + 1] << 63),
+            (b << 1) | (below[i - 1] >> 63), b, (b >> 1) | (below[i + 1] << 63));
+    }
+}
+
+// lifeWords for the rule given by birth and survive
+static inline void ruleWords(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int first, unsigned int last,
+                             unsigned int birth, unsigned int survive) {
+
+    for (unsigned int i = first; i <= last; i++) {
+
+        uint64_t a = above[i], r = row[i], b = below[i];
+
+        out[i] = ruleWord(
+            (a << 1) | (above[i - 1] >> 63), a, (a >> 1) | (above[i + 1] << 63),
+            (r << 1) | (row[i - 1] >> 63),   r, (r >> 1) | (row[i + 1] << 63),
+            (b << 1) | (below[i - 1] >> 63), b, (b >> 1) | (below[i + 1] << 63),
+            birth, survive);
+    }
+}
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameBitboard(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+bitmap BitMap_Init(unsigned width, unsigned height);
+void BitMap_Release(bitmap map);
+void setBit(bitmap map, unsigned int x, unsigned int y);
+int getBit(bitmap map, unsigned int x, unsigned int y);
+void wrapRow(uint64_t* row, unsigned int width, unsigned int words);
+void bitboardRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask);
+void nextGenerationBitboard(bitmap* map);
+const char* bitboardSelectKernel(void);
+const char* bitboardSelectRule(const life_rule* rule);
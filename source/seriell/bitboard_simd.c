@@ -0,0 +1,206 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Vectorized row kernels for the bitboard engine. AVX2 handles 256 cells,
+* AVX-512 512 cells per step; the adder tree is the same as in lifeWord,
+* with AVX-512 folding the three-input terms into VPTERNLOGQ.
+*
+* Referenzen:
+* Intel Intrinsics Guide: https://www.intel.com/content/www/us/en/docs/intrinsics-guide
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* User defined headers */
+#include "bitboard.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BITBOARD_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef BITBOARD_X86
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2     __attribute__((target("avx2")))
+#define TARGET_AVX512   __attribute__((target("avx512f")))
+#endif
+
+// =================================================
+//
+//                      AVX2
+//
+// =================================================
+
+TARGET_AVX2 static void bitboardRowAVX2(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask) {
+
+    unsigned int i = 1;
+
+    for (; i + 3 <= words; i += 4) {
+
+        __m256i a = _mm256_loadu_si256((const __m256i*)(above + i));
+        __m256i r = _mm256_loadu_si256((const __m256i*)(row + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(below + i));
+
+        // West/east neighbours: shift by one cell and carry the bit of the adjacent word
+        __m256i nw = _mm256_or_si256(_mm256_slli_epi64(a, 1), _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(above + i - 1)), 63));
+        __m256i ne = _mm256_or_si256(_mm256_srli_epi64(a, 1), _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(above + i + 1)), 63));
+        __m256i w  = _mm256_or_si256(_mm256_slli_epi64(r, 1), _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(row + i - 1)), 63));
+        __m256i e  = _mm256_or_si256(_mm256_srli_epi64(r, 1), _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(row + i + 1)), 63));
+        __m256i sw = _mm256_or_si256(_mm256_slli_epi64(b, 1), _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(below + i - 1)), 63));
+        __m256i se = _mm256_or_si256(_mm256_srli_epi64(b, 1), _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(below + i + 1)), 63));
+
+        __m256i x1 = _mm256_xor_si256(nw, a);
+        __m256i s1 = _mm256_xor_si256(x1, ne);
+        __m256i c1 = _mm256_or_si256(_mm256_and_si256(nw, a), _mm256_and_si256(ne, x1));
+
+        __m256i x3 = _mm256_xor_si256(sw, b);
+        __m256i s3 = _mm256_xor_si256(x3, se);
+        __m256i c3 = _mm256_or_si256(_mm256_and_si256(sw, b), _mm256_and_si256(se, x3));
+
+        __m256i s2 = _mm256_xor_si256(w, e);
+        __m256i c2 = _mm256_and_si256(w, e);
+
+        // Ones column
+        __m256i xs = _mm256_xor_si256(s1, s2);
+        __m256i ones = _mm256_xor_si256(xs, s3);
+        __m256i ca = _mm256_or_si256(_mm256_and_si256(s1, s2), _mm256_and_si256(s3, xs));
+
+        // Twos column
+        __m256i xc = _mm256_xor_si256(c1, c2);
+        __m256i t = _mm256_xor_si256(xc, c3);
+        __m256i tc = _mm256_or_si256(_mm256_and_si256(c1, c2), _mm256_and_si256(c3, xc));
+
+        __m256i next = _mm256_andnot_si256(tc, _mm256_xor_si256(t, ca));
+        next = _mm256_and_si256(next, _mm256_or_si256(ones, r));
+
+        _mm256_storeu_si256((__m256i*)(out + i), next);
+    }
+
+    lifeWords(above, row, below, out, i, words);
+    out[words] &= last_mask;
+}
+
+// =================================================
+//
+//                      AVX-512
+//
+// =================================================
+
+// imm8 truth tables for _mm512_ternarylogic_epi64(a, b, c, imm)
+#define TERN_XOR3       0x96    // a ^ b ^ c
+#define TERN_MAJ        0xE8    // (a & b) | (c & (a ^ b))
+#define TERN_ONE_OF_TWO 0x14    // (a ^ b) & ~c
+#define TERN_AND_OR     0xE0    // a & (b | c)
+
+TARGET_AVX512 static void bitboardRowAVX512(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, unsigned int words, uint64_t last_mask) {
+
+    unsigned int i = 1;
+
+    for (; i + 7 <= words; i += 8) {
+
+        __m512i a = _mm512_loadu_si512((const void*)(above + i));
+        __m512i r = _mm512_loadu_si512((const void*)(row + i));
+        __m512i b = _mm512_loadu_si512((const void*)(below + i));
+
+        __m512i nw = _mm512_or_si512(_mm512_slli_epi64(a, 1), _mm512_srli_epi64(_mm512_loadu_si512((const void*)(above + i - 1)), 63));
+        __m512i ne = _mm512_or_si512(_mm512_srli_epi64(a, 1), _mm512_slli_epi64(_mm512_loadu_si512((const void*)(above + i + 1)), 63));
+        __m512i w  = _mm512_or_si512(_mm512_slli_epi64(r, 1), _mm512_srli_epi64(_mm512_loadu_si512((const void*)(row + i - 1)), 63));
+        __m512i e  = _mm512_or_si512(_mm512_srli_epi64(r, 1), _mm512_slli_epi64(_mm512_loadu_si512((const void*)(row + i + 1)), 63));
+        __m512i sw = _mm512_or_si512(_mm512_slli_epi64(b, 1), _mm512_srli_epi64(_mm512_loadu_si512((const void*)(below + i - 1)), 63));
+        __m512i se = _mm512_or_si512(_mm512_srli_epi64(b, 1), _mm512_slli_epi64(_mm512_loadu_si512((const void*)(below + i + 1)), 63));
+
+        // Full adders for the rows above and below, half adder for the middle row
+        __m512i s1 = _mm512_ternarylogic_epi64(nw, a, ne, TERN_XOR3);
+        __m512i c1 = _mm512_ternarylogic_epi64(nw, a, ne, TERN_MAJ);
+        __m512i s3 = _mm512_ternarylogic_epi64(sw, b, se, TERN_XOR3);
+        __m512i c3 = _mm512_ternarylogic_epi64(sw, b, se, TERN_MAJ);
+        __m512i s2 = _mm512_xor_si512(w, e);
+        __m512i c2 = _mm512_and_si512(w, e);
+
+        __m512i ones = _mm512_ternarylogic_epi64(s1, s2, s3, TERN_XOR3);
+        __m512i ca = _mm512_ternarylogic_epi64(s1, s2, s3, TERN_MAJ);
+        __m512i t = _mm512_ternarylogic_epi64(c1, c2, c3, TERN_XOR3);
+        __m512i tc = _mm512_ternarylogic_epi64(c1, c2, c3, TERN_MAJ);
+
+        __m512i next = _mm512_ternarylogic_epi64(t, ca, tc, TERN_ONE_OF_TWO);
+        next = _mm512_ternarylogic_epi64(next, ones, r, TERN_AND_OR);
+
+        _mm512_storeu_si512((void*)(out + i), next);
+    }
+
+    lifeWords(above, row, below, out, i, words);
+    out[words] &= last_mask;
+}
+
+// =================================================
+//
+//                  CPU DETECTION
+//
+// =================================================
+
+#ifdef _MSC_VER
+static int cpuHasAVX2(int* avx512) {
+
+    int info[4];
+    unsigned long long xcr0;
+
+    *avx512 = 0;
+
+    __cpuid(info, 0);
+    if (info[0] < 7) return 0;
+
+    // OSXSAVE and AVX, then ask the OS which register states it saves
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return 0;
+    xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x06) != 0x06) return 0;
+
+    __cpuidex(info, 7, 0);
+    *avx512 = (info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6;
+
+    return (info[1] & (1 << 5)) != 0;
+}
+#else
+static int cpuHasAVX2(int* avx512) {
+
+    __builtin_cpu_init();
+    *avx512 = __builtin_cpu_supports("avx512f");
+
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#endif // BITBOARD_X86
+
+/*
+* Pick the widest row kernel the CPU supports. Called once at startup,
+* the portable kernel stays in place on everything else.
+*/
+const char* bitboardSelectKernel(void) {
+
+#ifdef BITBOARD_X86
+    int avx512;
+    int avx2 = cpuHasAVX2(&avx512);
+
+    if (avx512) {
+        bitboardRowKernel = bitboardRowAVX512;
+        return "AVX-512";
+    }
+    if (avx2) {
+        bitboardRowKernel = bitboardRowAVX2;
+        return "AVX2";
+    }
+#endif
+
+    bitboardRowKernel = bitboardRow;
+    return "portable";
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+#define CYCLE_HISTORY   8192    // direct mapped slots, a newer hash evicts an older one
+
+/*
+* The field hash is the XOR of a random key per live cell (Zobrist), so a
+* birth or death is one XOR. Equal hashes are taken as equal fields.
+*/
+typedef struct {
+    uint64_t hash;
+    unsigned int generation;    // 0: slot unused, else generation + 1
+} cycle_slot;
+
+typedef struct {
+    cycle_slot* slots;
+    unsigned int period;        // 0 until a cycle was found
+} cycle_history;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+void Cycle_Init(cycle_history* history);
+void Cycle_Release(cycle_history* history);
+unsigned int Cycle_Skip(cycle_history* history, uint64_t hash, unsigned int generation, unsigned int frames);
+
+// Key of cell (x, y): splitmix64 of the cell index
+static inline uint64_t cycleKey(unsigned int x, unsigned int y, unsigned int width) {
+
+    uint64_t z = ((uint64_t)y * width + x + 1) * 0x9E3779B97F4A7C15ull;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
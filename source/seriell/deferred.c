@@ -0,0 +1,189 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Count map with deferred updates: the scan only records births and deaths
+* per row, the neighbour counts are then brought up to date one row at a
+* time. Every row is written in one pass instead of receiving scattered
+* read-modify-writes from three different scan rows.
+*
+* Referenzen:
+* Game Of Life:   https://github.com/jagregory/abrash-black-book (Chapter 17)
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "deferred.h"
+#include "mem_optimized.h"
+#include "life106.h"
+
+/*
+* x coordinates of the flips of every row, in scan order: row y owns the
+* entries start[y] up to start[y + 1].
+*/
+typedef struct {
+    unsigned int* x;
+    unsigned int* start;
+    unsigned int count;
+    unsigned int capacity;
+} row_list;
+
+static void rowListInit(row_list* list, unsigned int height) {
+    list->x = NULL;
+    list->start = (unsigned int*)xmalloc((height + 1) * sizeof(unsigned int));
+    list->count = 0;
+    list->capacity = 0;
+}
+
+static void rowListRelease(row_list* list) {
+    free(list->x);
+    free(list->start);
+}
+
+static inline void rowListAppend(row_list* list, unsigned int x) {
+
+    if (list->count == list->capacity) {
+        list->capacity = (list->capacity == 0) ? 1024 : list->capacity * 2;
+        list->x = (unsigned int*)realloc(list->x, list->capacity * sizeof(unsigned int));
+        if (list->x == NULL) {
+            fprintf(stderr, "Allocation error...\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    list->x[list->count++] = x;
+}
+
+// Record the births and deaths of row y, the map is only read
+static void scanRow(cell* Cell, unsigned int y, row_list* births, row_list* deaths) {
+
+    unsigned int x, count, w = Cell->width;
+    unsigned char* row = Cell->ptr + y * Cell->stride;
+
+    if (rowsLive(Cell, y) == 0) return;
+
+    for (x = nextNonZero(row, 0, w); x < w; x = nextNonZero(row, x + 1, w)) {
+
+        count = row[x] >> 1; // # of neighboring on-cells
+        if (row[x] & 0x01) {
+            if ((count != 2) && (count != 3)) rowListAppend(deaths, x);
+        }
+        else {
+            if (count == 3) rowListAppend(births, x);
+        }
+    }
+}
+
+// Flips of row from in the row above or below: all three columns count
+static inline void addColumns(unsigned char* row, const row_list* list, unsigned int from, unsigned char delta) {
+
+    for (unsigned int i = list->start[from]; i < list->start[from + 1]; i++) {
+        unsigned char* cell_ptr = row + list->x[i];
+        cell_ptr[-1] += delta;
+        cell_ptr[0] += delta;
+        cell_ptr[1] += delta;
+    }
+}
+
+// Flips within the row itself: state bit plus left and right neighbour
+static inline void addOwn(cell* Cell, unsigned char* row, const row_list* list, unsigned int y, unsigned char delta) {
+
+    for (unsigned int i = list->start[y]; i < list->start[y + 1]; i++) {
+        unsigned char* cell_ptr = row + list->x[i];
+        cell_ptr[-1] += delta;
+        cell_ptr[0] ^= 0x01;
+        cell_ptr[1] += delta;
+        countLive(Cell->live, list->x[i], y, cell_ptr[0] & 0x01);
+    }
+}
+
+/*
+* Bring row y up to date from the flips of rows y - 1, y and y + 1, which
+* must all have been scanned. The ghost bytes are folded back right away.
+*/
+static void applyRow(cell* Cell, unsigned int y, const row_list* births, const row_list* deaths) {
+
+    unsigned int w = Cell->width, h = Cell->height;
+    unsigned int above = (y == 0) ? h - 1 : y - 1;
+    unsigned int below = (y == h - 1) ? 0 : y + 1;
+    unsigned char* row = Cell->ptr + y * Cell->stride;
+    const unsigned char increase = 0x02, decrease = (unsigned char)-0x02;
+
+    addColumns(row, births, above, increase);
+    addColumns(row, deaths, above, decrease);
+    addColumns(row, births, below, increase);
+    addColumns(row, deaths, below, decrease);
+    addOwn(Cell, row, births, y, increase);
+    addOwn(Cell, row, deaths, y, decrease);
+
+    row[w - 1] += row[-1];
+    row[0] += row[w];
+    row[-1] = 0;
+    row[w] = 0;
+}
+
+/*
+* Row y can be applied once row y + 1 is scanned, so the two phases run
+* one row apart over the map. Row 0 waits for the scan of the last row.
+*/
+static void nextGenerationDeferred(cell* Cell, row_list* births, row_list* deaths) {
+
+    unsigned int y, h = Cell->height;
+
+    births->count = 0;
+    deaths->count = 0;
+    births->start[0] = 0;
+    deaths->start[0] = 0;
+
+    for (y = 0; y < h; y++) {
+        scanRow(Cell, y, births, deaths);
+        births->start[y + 1] = births->count;
+        deaths->start[y + 1] = deaths->count;
+
+        if (y >= 2) applyRow(Cell, y - 1, births, deaths);
+    }
+
+    applyRow(Cell, h - 1, births, deaths);
+    if (h > 1) applyRow(Cell, 0, births, deaths);
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameDeferred(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    cell map;
+    row_list births, deaths;
+
+    GameMap_Init(&map, width, height);
+    life106_read_file_memory(input_field_filename, &map);
+    foldBorder(map);
+
+    rowListInit(&births, height);
+    rowListInit(&deaths, height);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        nextGenerationDeferred(&map, &births, &deaths);
+    }
+
+    clock_t end = clock();
+
+    life106_save_file_memory(output_field_filename, &map);
+
+    rowListRelease(&births);
+    rowListRelease(&deaths);
+    GameMap_Release(&map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
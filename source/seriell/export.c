@@ -39,7 +39,7 @@ void exportDataArray(char* filename, double data[], size_t array_length, int pro
 	}
 }
 
-void exportJson(char* filename, double data[], size_t array_length, int field_size[], int process_count, int frames, char* folder_name) {
+void exportJson(char* filename, double data[], size_t array_length, int field_size[], int process_count, unsigned long long frames, char* folder_name) {
 
 	FILE* fptr;
 	errno_t err_file, err_time;
@@ -77,7 +77,7 @@ void exportJson(char* filename, double data[], size_t array_length, int field_si
 		fprintf(fptr, "{");
 		fprintf(fptr, "\"method\" : \"%s\", ", filename);
 		fprintf(fptr, "\"threads\" : %i, ", process_count);
-		fprintf(fptr, "\"frames\" : %i, ", frames);
+		fprintf(fptr, "\"frames\" : %llu, ", frames);
 		for (int idx = 0; idx < array_length; idx++) {
 			fprintf(fptr, "\"size\" : %i, ", field_size[idx]);
 			fprintf(fptr, "\"time\" : %lf, ", data[idx]);
@@ -7,4 +7,4 @@
 // =================================================
 
 void exportDataArray(char* filename, double data[], size_t array_length);
-void exportJson(char* filename, double data[], size_t array_length, int field_size[], int process_count, int frames, char* folder_name);
\ No newline at end of file
+void exportJson(char* filename, double data[], size_t array_length, int field_size[], int process_count, unsigned long long frames, char* folder_name);
\ No newline at end of file
@@ -6,6 +6,26 @@
 #include <stdlib.h>
 #include <string.h>
 
+static void* field_alloc(size_t bytes)
+{
+#ifdef _MSC_VER
+	return _aligned_malloc(bytes, FIELD_ALIGNMENT);
+#else
+	void* block = NULL;
+	if (posix_memalign(&block, FIELD_ALIGNMENT, bytes) != 0) return NULL;
+	return block;
+#endif
+}
+
+static void field_free(void* block)
+{
+#ifdef _MSC_VER
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+
 field_t* field_new(unsigned height, unsigned width)
 {
 	field_t* field = malloc(sizeof(field_t));
@@ -13,39 +33,36 @@ field_t* field_new(unsigned height, unsigned width)
 
 	field->height = height;
 	field->width = width;
+	field->stride = (width + FIELD_ALIGNMENT - 1) / FIELD_ALIGNMENT * FIELD_ALIGNMENT;
 
-	field->rows = malloc(sizeof(unsigned*) * height);
-	if (field->rows == NULL)
+	// front buffer | back buffer | scratch row
+	size_t buffer_size = (size_t)field->stride * height;
+	size_t scratch_size = (field->stride + 2 + FIELD_ALIGNMENT - 1) / FIELD_ALIGNMENT * FIELD_ALIGNMENT;
+
+	field->block = field_alloc(2 * buffer_size + scratch_size);
+	if (field->block == NULL)
 	{
 		free(field);
 		return NULL;
 	}
-	memset(field->rows, 0, height);
+	memset(field->block, 0, 2 * buffer_size + scratch_size);
 
-	for_i(y, height)
-	{
-		field->rows[y] = malloc(sizeof(unsigned) * width);
-		if (field->rows[y] == NULL)
-		{
-			field_delete(field);
-			return NULL;
-		}
-	}
+	field->cells = (unsigned char*)field->block;
+	field->back = field->cells + buffer_size;
+	field->sums = field->back + buffer_size;
 
 	return field;
 }
 
 void field_delete(field_t* field)
 {
-	for_i(y, field->height)
-	{
-		if (field->rows[y] != NULL)
-		{
-			free(field->rows[y]);
-			field->rows[y] = NULL;
-		}
-	}
-
-	free(field->rows);
+	field_free(field->block);
 	free(field);
 }
+
+void field_swap(field_t* field)
+{
+	unsigned char* temp = field->cells;
+	field->cells = field->back;
+	field->back = temp;
+}
@@ -1,11 +1,35 @@
 #pragma once
 
+#include <stddef.h>
+
+#define FIELD_ALIGNMENT 64
+
+/*
+* Front and back buffer share one aligned allocation of 1-byte cells.
+* Rows start on FIELD_ALIGNMENT boundaries (stride >= width); evolve writes
+* the back buffer and field_swap makes it the current generation.
+*/
 typedef struct
 {
 	unsigned height;
 	unsigned width;
-	unsigned** rows;
+	unsigned stride;
+	unsigned char* cells;	// current generation
+	unsigned char* back;	// next generation
+	unsigned char* sums;	// scratch row (stride + 2 bytes) for the kernels
+	void* block;
 } field_t;
 
 field_t* field_new(unsigned height, unsigned width);
 void field_delete(field_t* field);
+void field_swap(field_t* field);
+
+static inline unsigned char* field_row(const field_t* field, unsigned y)
+{
+	return field->cells + (size_t)y * field->stride;
+}
+
+static inline unsigned char* field_back_row(const field_t* field, unsigned y)
+{
+	return field->back + (size_t)y * field->stride;
+}
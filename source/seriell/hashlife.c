@@ -0,0 +1,483 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* HashLife: the field is a quadtree of hash-consed nodes, the centre of a
+* node after 2^(level - 2) generations is computed once and memoised. A
+* run of n generations is split into its binary digits, each one jump of
+* 2^k generations, so the cost depends on the pattern and not on n.
+*
+* The torus of the other engines is kept: the field is a square of side
+* 2^k and is tiled with copies of itself before every jump, copies are the
+* same node and cost nothing.
+*
+* Referenzen:
+* HashLife:       Gosper, Exploiting Regularities in Large Cellular Spaces (1984)
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "hashlife.h"
+#include "mem_optimized.h"
+#include "life106.h"
+#include "utils.h"
+
+// The two level 0 nodes, they live outside the hash table
+static hashlife_node dead_cell = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, 0 };
+static hashlife_node live_cell = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, 0 };
+
+static inline size_t hashNode(const hashlife_node* nw, const hashlife_node* ne, const hashlife_node* sw, const hashlife_node* se) {
+
+    uint64_t h = (uint64_t)(uintptr_t)nw;
+    h = h * 0x9E3779B97F4A7C15ull + (uint64_t)(uintptr_t)ne;
+    h = h * 0x9E3779B97F4A7C15ull + (uint64_t)(uintptr_t)sw;
+    h = h * 0x9E3779B97F4A7C15ull + (uint64_t)(uintptr_t)se;
+    h ^= h >> 29;
+
+    return (size_t)h;
+}
+
+static hashlife_node* allocNode(hashlife* map) {
+
+    hashlife_node* node;
+    size_t i;
+
+    if (map->free_nodes == NULL) {
+        node = (hashlife_node*)xmalloc(HASHLIFE_CHUNK * sizeof(hashlife_node));
+        for (i = 0; i < HASHLIFE_CHUNK; i++) {
+            node[i].next = map->free_nodes;
+            map->free_nodes = node + i;
+        }
+
+        map->chunks = (hashlife_node**)realloc(map->chunks, (map->chunk_count + 1) * sizeof(hashlife_node*));
+        if (map->chunks == NULL) {
+            fprintf(stderr, "Allocation error...\n");
+            exit(EXIT_FAILURE);
+        }
+        map->chunks[map->chunk_count++] = node;
+    }
+
+    node = map->free_nodes;
+    map->free_nodes = node->next;
+
+    return node;
+}
+
+static void growTable(hashlife* map) {
+
+    size_t i, count = map->bucket_count * 2;
+    hashlife_node** buckets = (hashlife_node**)xmalloc(count * sizeof(hashlife_node*));
+    hashlife_node* node;
+    hashlife_node* next;
+
+    memset(buckets, 0, count * sizeof(hashlife_node*));
+
+    for (i = 0; i < map->bucket_count; i++) {
+        for (node = map->buckets[i]; node != NULL; node = next) {
+            next = node->next;
+            size_t index = hashNode(node->nw, node->ne, node->sw, node->se) & (count - 1);
+            node->next = buckets[index];
+            buckets[index] = node;
+        }
+    }
+
+    free(map->buckets);
+    map->buckets = buckets;
+    map->bucket_count = count;
+}
+
+// The one node with these four quadrants
+static hashlife_node* joinNode(hashlife* map, hashlife_node* nw, hashlife_node* ne, hashlife_node* sw, hashlife_node* se) {
+
+    size_t index = hashNode(nw, ne, sw, se) & (map->bucket_count - 1);
+    hashlife_node* node;
+
+    for (node = map->buckets[index]; node != NULL; node = node->next) {
+        if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) return node;
+    }
+
+    node = allocNode(map);
+    node->nw = nw;
+    node->ne = ne;
+    node->sw = sw;
+    node->se = se;
+    node->result = NULL;
+    node->step_result = NULL;
+    node->level = (unsigned char)(nw->level + 1);
+    node->step = 0;
+    node->mark = 0;
+    node->next = map->buckets[index];
+    map->buckets[index] = node;
+
+    if (++map->node_count > map->bucket_count) growTable(map);
+
+    return node;
+}
+
+// Centre quarter of a node, no time passes
+static inline hashlife_node* centreNode(hashlife* map, const hashlife_node* node) {
+    return joinNode(map, node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+// Level 2: the centre 2x2 of a 4x4 block after one generation, by counting
+static hashlife_node* baseResult(hashlife* map, const hashlife_node* node) {
+
+    const hashlife_node* quadrants[4] = { node->nw, node->ne, node->sw, node->se };
+    const hashlife_node* half;
+    hashlife_node* centre[4];
+    unsigned int bits = 0, x, y, dx, dy, count, alive;
+
+    // Bit 4y + x is the cell (x, y) of the block
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 4; x++) {
+            half = quadrants[(y >> 1) * 2 + (x >> 1)];
+            const hashlife_node* cells[4] = { half->nw, half->ne, half->sw, half->se };
+            if (cells[(y & 1) * 2 + (x & 1)] == &live_cell) bits |= 1u << (4 * y + x);
+        }
+    }
+
+    for (y = 1; y <= 2; y++) {
+        for (x = 1; x <= 2; x++) {
+
+            count = 0;
+            for (dy = y - 1; dy <= y + 1; dy++)
+                for (dx = x - 1; dx <= x + 1; dx++)
+                    count += (bits >> (4 * dy + dx)) & 1;
+
+            alive = (bits >> (4 * y + x)) & 1;
+            count -= alive;
+            centre[(y - 1) * 2 + (x - 1)] = (count == 3 || (count == 2 && alive)) ? &live_cell : &dead_cell;
+        }
+    }
+
+    return joinNode(map, centre[0], centre[1], centre[2], centre[3]);
+}
+
+/*
+* Centre of node after 2^step generations, step <= level - 2. The node is
+* cut into nine overlapping sub-nodes which are advanced first; their
+* results form four nodes that are either advanced again (full step) or
+* only cut down to their centre (smaller step).
+*/
+static hashlife_node* advanceNode(hashlife* map, hashlife_node* node, unsigned int step) {
+
+    hashlife_node* sub[9];
+    hashlife_node* quarter[4];
+    hashlife_node* result;
+    unsigned int i, full = (step == node->level - 2u);
+
+    if (node == map->empty[node->level]) return map->empty[node->level - 1];
+    if (full && node->result != NULL) return node->result;
+    if (!full && node->step_result != NULL && node->step == step) return node->step_result;
+
+    if (node->level == 2) {
+        result = baseResult(map, node);
+    }
+    else {
+        sub[0] = node->nw;
+        sub[1] = joinNode(map, node->nw->ne, node->ne->nw, node->nw->se, node->ne->sw);
+        sub[2] = node->ne;
+        sub[3] = joinNode(map, node->nw->sw, node->nw->se, node->sw->nw, node->sw->ne);
+        sub[4] = joinNode(map, node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+        sub[5] = joinNode(map, node->ne->sw, node->ne->se, node->se->nw, node->se->ne);
+        sub[6] = node->sw;
+        sub[7] = joinNode(map, node->sw->ne, node->se->nw, node->sw->se, node->se->sw);
+        sub[8] = node->se;
+
+        for (i = 0; i < 9; i++) {
+            sub[i] = advanceNode(map, sub[i], full ? node->level - 3u : step);
+        }
+
+        quarter[0] = joinNode(map, sub[0], sub[1], sub[3], sub[4]);
+        quarter[1] = joinNode(map, sub[1], sub[2], sub[4], sub[5]);
+        quarter[2] = joinNode(map, sub[3], sub[4], sub[6], sub[7]);
+        quarter[3] = joinNode(map, sub[4], sub[5], sub[7], sub[8]);
+
+        for (i = 0; i < 4; i++) {
+            quarter[i] = full ? advanceNode(map, quarter[i], node->level - 3u) : centreNode(map, quarter[i]);
+        }
+
+        result = joinNode(map, quarter[0], quarter[1], quarter[2], quarter[3]);
+    }
+
+    if (full) {
+        node->result = result;
+    }
+    else {
+        node->step_result = result;
+        node->step = (unsigned char)step;
+    }
+
+    return result;
+}
+
+// =================================================
+//
+//                  GARBAGE COLLECTION
+//
+// =================================================
+
+static void markNode(hashlife_node* node) {
+
+    if (node->level == 0 || node->mark) return;
+
+    node->mark = 1;
+    markNode(node->nw);
+    markNode(node->ne);
+    markNode(node->sw);
+    markNode(node->se);
+}
+
+/*
+* Keep everything reachable from the root and the empty nodes, results of
+* kept nodes survive as long as they are kept themselves.
+*/
+static void collectGarbage(hashlife* map) {
+
+    hashlife_node** link;
+    hashlife_node* node;
+    size_t i;
+
+    markNode(map->root);
+    for (i = 1; i < HASHLIFE_LEVELS; i++) markNode(map->empty[i]);
+
+    for (i = 0; i < map->bucket_count; i++) {
+        for (node = map->buckets[i]; node != NULL; node = node->next) {
+            if (!node->mark) continue;
+            if (node->result != NULL && !node->result->mark) node->result = NULL;
+            if (node->step_result != NULL && !node->step_result->mark) node->step_result = NULL;
+        }
+    }
+
+    for (i = 0; i < map->bucket_count; i++) {
+        link = map->buckets + i;
+        while ((node = *link) != NULL) {
+            if (node->mark) {
+                node->mark = 0;
+                link = &node->next;
+            }
+            else {
+                *link = node->next;
+                node->next = map->free_nodes;
+                map->free_nodes = node;
+                map->node_count--;
+            }
+        }
+    }
+
+    // Most nodes are still in use: collecting again soon would not help
+    if (map->node_count > map->gc_limit / 2) map->gc_limit *= 2;
+}
+
+// =================================================
+//
+//                  MAP
+//
+// =================================================
+
+void HashLife_Init(hashlife* map, unsigned size) {
+
+    unsigned int i;
+
+    map->size = size;
+    map->level = ctz64(size);
+
+    map->bucket_count = 1 << 16;
+    map->buckets = (hashlife_node**)xmalloc(map->bucket_count * sizeof(hashlife_node*));
+    memset(map->buckets, 0, map->bucket_count * sizeof(hashlife_node*));
+    map->node_count = 0;
+    map->gc_limit = 1 << 21;
+    map->free_nodes = NULL;
+    map->chunks = NULL;
+    map->chunk_count = 0;
+
+    map->pending = NULL;
+    map->pending_count = 0;
+    map->pending_capacity = 0;
+
+    map->empty[0] = &dead_cell;
+    for (i = 1; i < HASHLIFE_LEVELS; i++) {
+        map->empty[i] = joinNode(map, map->empty[i - 1], map->empty[i - 1], map->empty[i - 1], map->empty[i - 1]);
+    }
+    map->root = map->empty[map->level];
+}
+
+void HashLife_Release(hashlife* map) {
+
+    for (size_t i = 0; i < map->chunk_count; i++) free(map->chunks[i]);
+
+    free(map->chunks);
+    free(map->buckets);
+    free(map->pending);
+}
+
+// Cells are packed as (y << 32) | x, which sorts them row by row
+static void pushCell(uint64_t** cells, size_t* count, size_t* capacity, uint64_t key) {
+
+    if (*count == *capacity) {
+        *capacity = (*capacity == 0) ? 1024 : *capacity * 2;
+        *cells = (uint64_t*)realloc(*cells, *capacity * sizeof(uint64_t));
+        if (*cells == NULL) {
+            fprintf(stderr, "Allocation error...\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    (*cells)[(*count)++] = key;
+}
+
+// Cells are collected and go into the tree at once in HashLife_Build
+void HashLife_SetCell(hashlife* map, unsigned int x, unsigned int y) {
+    pushCell(&map->pending, &map->pending_count, &map->pending_capacity, ((uint64_t)y << 32) | x);
+}
+
+// Move the cells without bit to the front, return how many there are
+static size_t partitionCells(uint64_t* cells, size_t count, uint64_t bit) {
+
+    size_t i = 0, j = count;
+    uint64_t swap;
+
+    while (i < j) {
+        if (cells[i] & bit) {
+            swap = cells[--j];
+            cells[j] = cells[i];
+            cells[i] = swap;
+        }
+        else {
+            i++;
+        }
+    }
+
+    return i;
+}
+
+static hashlife_node* buildNode(hashlife* map, uint64_t* cells, size_t count, unsigned int level) {
+
+    size_t top, top_left, bottom_left;
+    uint64_t x_bit, y_bit;
+
+    if (count == 0) return map->empty[level];
+    if (level == 0) return &live_cell;
+
+    x_bit = 1ull << (level - 1);
+    y_bit = x_bit << 32;
+
+    top = partitionCells(cells, count, y_bit);
+    top_left = partitionCells(cells, top, x_bit);
+    bottom_left = partitionCells(cells + top, count - top, x_bit);
+
+    return joinNode(map,
+        buildNode(map, cells, top_left, level - 1),
+        buildNode(map, cells + top_left, top - top_left, level - 1),
+        buildNode(map, cells + top, bottom_left, level - 1),
+        buildNode(map, cells + top + bottom_left, count - top - bottom_left, level - 1));
+}
+
+void HashLife_Build(hashlife* map) {
+
+    map->root = buildNode(map, map->pending, map->pending_count, map->level);
+
+    free(map->pending);
+    map->pending = NULL;
+    map->pending_count = 0;
+    map->pending_capacity = 0;
+}
+
+/*
+* One jump per set bit of generations. The torus is tiled up to a level
+* where the jump fits and the centre starts on a multiple of the field
+* side, so its north-west corner is the field again.
+*/
+void HashLife_Advance(hashlife* map, unsigned long long generations) {
+
+    hashlife_node* node;
+    unsigned int step, level;
+
+    for (step = 0; generations != 0; step++, generations >>= 1) {
+
+        if (!(generations & 1)) continue;
+
+        level = (map->level > step) ? map->level + 2 : step + 2;
+
+        node = map->root;
+        while (node->level < level) node = joinNode(map, node, node, node, node);
+
+        node = advanceNode(map, node, step);
+        while (node->level > map->level) node = node->nw;
+        map->root = node;
+
+        if (map->node_count > map->gc_limit) collectGarbage(map);
+    }
+}
+
+static void collectCells(hashlife* map, const hashlife_node* node, unsigned int x, unsigned int y, uint64_t** cells, size_t* count, size_t* capacity) {
+
+    unsigned int half;
+
+    if (node == map->empty[node->level]) return;
+
+    if (node->level == 0) {
+        pushCell(cells, count, capacity, ((uint64_t)y << 32) | x);
+        return;
+    }
+
+    half = 1u << (node->level - 1);
+    collectCells(map, node->nw, x, y, cells, count, capacity);
+    collectCells(map, node->ne, x + half, y, cells, count, capacity);
+    collectCells(map, node->sw, x, y + half, cells, count, capacity);
+    collectCells(map, node->se, x + half, y + half, cells, count, capacity);
+}
+
+static int compareCells(const void* a, const void* b) {
+
+    uint64_t left = *(const uint64_t*)a, right = *(const uint64_t*)b;
+
+    return (left > right) - (left < right);
+}
+
+// Live cells in row order as (y << 32) | x, the caller frees the array
+size_t HashLife_Cells(hashlife* map, uint64_t** cells) {
+
+    size_t count = 0, capacity = 0;
+
+    *cells = NULL;
+    collectCells(map, map->root, 0, 0, cells, &count, &capacity);
+    qsort(*cells, count, sizeof(uint64_t), compareCells);
+
+    return count;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameHashLife(unsigned width, unsigned height, unsigned long long generations, char* input_field_filename, char* output_field_filename) {
+
+    hashlife map;
+
+    if (width != height || (width & (width - 1)) != 0) error("HashLife needs a square field with a power of two side!");
+
+    HashLife_Init(&map, width);
+    life106_read_file_hashlife(input_field_filename, &map);
+    HashLife_Build(&map);
+
+    clock_t start = clock();
+
+    HashLife_Advance(&map, generations);
+
+    clock_t end = clock();
+
+    life106_save_file_hashlife(output_field_filename, &map);
+
+    HashLife_Release(&map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+/*
+* Quadtree node of level k covering 2^k x 2^k cells. Level 0 nodes are the
+* two cells, every other node exists once per distinct content (hash
+* consing), so equal subtrees are shared and their results memoised once.
+*/
+typedef struct hashlife_node {
+    struct hashlife_node* nw;
+    struct hashlife_node* ne;
+    struct hashlife_node* sw;
+    struct hashlife_node* se;
+    struct hashlife_node* next;     // hash chain
+    struct hashlife_node* result;   // centre after 2^(level - 2) generations
+    struct hashlife_node* step_result; // centre after 2^step generations
+    unsigned char level;
+    unsigned char step;
+    unsigned char mark;
+} hashlife_node;
+
+#define HASHLIFE_LEVELS     72      // enough for 2^64 generations on the largest field
+#define HASHLIFE_CHUNK      4096    // nodes allocated at once
+
+typedef struct {
+    unsigned int size;              // side of the torus, 2^level
+    unsigned int level;
+    hashlife_node* root;
+    hashlife_node* empty[HASHLIFE_LEVELS];
+    hashlife_node** buckets;
+    size_t bucket_count;
+    size_t node_count;
+    size_t gc_limit;                // collect garbage above this many nodes
+    hashlife_node* free_nodes;
+    hashlife_node** chunks;
+    size_t chunk_count;
+    uint64_t* pending;              // cells set since the last HashLife_Build
+    size_t pending_count;
+    size_t pending_capacity;
+} hashlife;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameHashLife(unsigned width, unsigned height, unsigned long long generations, char* input_field_filename, char* output_field_filename);
+void HashLife_Init(hashlife* map, unsigned size);
+void HashLife_Release(hashlife* map);
+void HashLife_SetCell(hashlife* map, unsigned int x, unsigned int y);
+void HashLife_Build(hashlife* map);
+void HashLife_Advance(hashlife* map, unsigned long long generations);
+size_t HashLife_Cells(hashlife* map, uint64_t** cells);
@@ -0,0 +1,330 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Run-length rows: every row is a sorted list of live intervals. The
+* neighbour count of a cell only changes one cell before, at or after an
+* interval border of the rows above, below or the row itself, so the next
+* row is evaluated once per segment between those points instead of once
+* per cell. Time and memory follow the number of runs, not the width.
+*
+* Referenzen:
+* Game Of Life:   https://github.com/jagregory/abrash-black-book (Chapter 17)
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+/* User defined headers */
+#include "intervals.h"
+#include "mem_optimized.h"
+#include "life106.h"
+
+static void* growArray(void* data, unsigned int* capacity, unsigned int needed, size_t size) {
+
+    if (needed <= *capacity) return data;
+
+    while (*capacity < needed) {
+        *capacity = (*capacity == 0) ? 16 : *capacity * 2;
+    }
+
+    data = realloc(data, (size_t)*capacity * size);
+    if (data == NULL) {
+        fprintf(stderr, "Allocation error...\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return data;
+}
+
+// Append a run behind the last one, touching runs are merged
+static inline void appendRun(interval_row* row, int start, int end) {
+
+    if (row->count > 0 && row->runs[row->count - 1].end == start) {
+        row->runs[row->count - 1].end = end;
+        return;
+    }
+
+    row->runs = (interval*)growArray(row->runs, &row->capacity, row->count + 1, sizeof(interval));
+    row->runs[row->count].start = start;
+    row->runs[row->count].end = end;
+    row->count++;
+}
+
+void Intervals_Init(interval_map* map, unsigned width, unsigned height) {
+
+    map->width = width;
+    map->height = height;
+    map->rows = (interval_row*)xmalloc(height * sizeof(interval_row));
+    map->temp_rows = (interval_row*)xmalloc(height * sizeof(interval_row));
+    memset(map->rows, 0, height * sizeof(interval_row));
+    memset(map->temp_rows, 0, height * sizeof(interval_row));
+
+    for (int i = 0; i < 3; i++) map->ext[i] = NULL;
+    for (int i = 0; i < 4; i++) map->points[i] = NULL;
+    map->ext_capacity = 0;
+    map->points_capacity = 0;
+    map->peak_runs = 0;
+}
+
+void Intervals_Release(interval_map* map) {
+
+    for (unsigned int y = 0; y < map->height; y++) {
+        free(map->rows[y].runs);
+        free(map->temp_rows[y].runs);
+    }
+
+    for (int i = 0; i < 3; i++) free(map->ext[i]);
+    for (int i = 0; i < 4; i++) free(map->points[i]);
+    free(map->rows);
+    free(map->temp_rows);
+}
+
+void Intervals_SetCell(interval_map* map, unsigned int x, unsigned int y) {
+
+    interval_row* row = map->rows + y;
+    unsigned int lo = 0, hi = row->count, i;
+    int cell = (int)x;
+
+    // First run that ends at or behind the cell
+    while (lo < hi) {
+        i = (lo + hi) / 2;
+        if (row->runs[i].end < cell) lo = i + 1;
+        else hi = i;
+    }
+    i = lo;
+
+    if (i < row->count && row->runs[i].start <= cell && cell < row->runs[i].end) return;
+
+    if (i < row->count && row->runs[i].end == cell) {
+        row->runs[i].end = cell + 1;
+        if (i + 1 < row->count && row->runs[i + 1].start == cell + 1) {
+            row->runs[i].end = row->runs[i + 1].end;
+            memmove(row->runs + i + 1, row->runs + i + 2, (row->count - i - 2) * sizeof(interval));
+            row->count--;
+        }
+        return;
+    }
+
+    if (i < row->count && row->runs[i].start == cell + 1) {
+        row->runs[i].start = cell;
+        return;
+    }
+
+    row->runs = (interval*)growArray(row->runs, &row->capacity, row->count + 1, sizeof(interval));
+    memmove(row->runs + i + 1, row->runs + i, (row->count - i) * sizeof(interval));
+    row->runs[i].start = cell;
+    row->runs[i].end = cell + 1;
+    row->count++;
+}
+
+/*
+* Copy of a row with the torus wrap made explicit: a run touching the
+* right border reappears at -1, one touching the left border at width.
+*/
+static unsigned int extendRow(const interval_row* row, int width, interval* ext) {
+
+    unsigned int n = 0;
+
+    if (row->count == 0) return 0;
+
+    if (row->runs[row->count - 1].end == width) {
+        ext[n].start = -1;
+        ext[n++].end = 0;
+    }
+
+    memcpy(ext + n, row->runs, row->count * sizeof(interval));
+    n += row->count;
+
+    if (row->runs[0].start == 0) {
+        ext[n].start = width;
+        ext[n++].end = width + 1;
+    }
+
+    return n;
+}
+
+/*
+* Cells where the three-cell window sum of a row can change: one before,
+* at and after every run border. The list is nearly sorted on creation,
+* the insertion only ever moves a point past a few neighbours.
+*/
+static unsigned int rowPoints(const interval* ext, unsigned int n, int width, int* points) {
+
+    unsigned int k = 1, i, j;
+    int d, p, border;
+
+    points[0] = 0;
+
+    for (i = 0; i < n; i++) {
+        for (d = 0; d < 6; d++) {
+
+            border = (d < 3) ? ext[i].start : ext[i].end;
+            p = border + (d % 3) - 1;
+            if (p < 0 || p >= width) continue;
+
+            for (j = k; j > 0 && points[j - 1] > p; j--);
+            if (j > 0 && points[j - 1] == p) continue;
+
+            memmove(points + j + 1, points + j, (k - j) * sizeof(int));
+            points[j] = p;
+            k++;
+        }
+    }
+
+    return k;
+}
+
+static unsigned int mergePoints(const int* a, unsigned int na, const int* b, unsigned int nb, const int* c, unsigned int nc, int* out) {
+
+    unsigned int i = 0, j = 0, k = 0, m = 0;
+    int p;
+
+    while (i < na || j < nb || k < nc) {
+
+        p = INT_MAX;
+        if (i < na && a[i] < p) p = a[i];
+        if (j < nb && b[j] < p) p = b[j];
+        if (k < nc && c[k] < p) p = c[k];
+
+        if (i < na && a[i] == p) i++;
+        if (j < nb && b[j] == p) j++;
+        if (k < nc && c[k] == p) k++;
+
+        out[m++] = p;
+    }
+
+    return m;
+}
+
+// Live cells among x - 1, x and x + 1; x only ever grows between calls
+static inline int windowCount(const interval* ext, unsigned int n, unsigned int* cursor, int x, int* alive) {
+
+    unsigned int j;
+    int sum = 0, lo, hi;
+
+    while (*cursor < n && ext[*cursor].end <= x - 1) (*cursor)++;
+
+    for (j = *cursor; j < n && ext[j].start <= x + 1; j++) {
+        lo = (ext[j].start > x - 1) ? ext[j].start : x - 1;
+        hi = (ext[j].end < x + 2) ? ext[j].end : x + 2;
+        sum += hi - lo;
+        if (ext[j].start <= x && x < ext[j].end) *alive = 1;
+    }
+
+    return sum;
+}
+
+static void nextRow(interval_map* map, unsigned int y) {
+
+    unsigned int h = map->height, i, m;
+    int w = (int)map->width;
+    const interval_row* above = map->rows + ((y == 0) ? h - 1 : y - 1);
+    const interval_row* row = map->rows + y;
+    const interval_row* below = map->rows + ((y == h - 1) ? 0 : y + 1);
+    interval_row* out = map->temp_rows + y;
+    unsigned int na, nc, nb, pa, pc, pb;
+    unsigned int ca = 0, cc = 0, cb = 0;
+    int x, end, count, alive, unused;
+
+    out->count = 0;
+    if (above->count == 0 && row->count == 0 && below->count == 0) return;
+
+    // Scratch for the busiest row so far, wrapping adds up to two runs
+    m = above->count;
+    if (row->count > m) m = row->count;
+    if (below->count > m) m = below->count;
+    m += 2;
+    if (m > map->ext_capacity) {
+        for (i = 0; i < 3; i++) {
+            unsigned int capacity = map->ext_capacity;
+            map->ext[i] = (interval*)growArray(map->ext[i], &capacity, m, sizeof(interval));
+        }
+        map->ext_capacity = m;
+    }
+
+    na = extendRow(above, w, map->ext[0]);
+    nc = extendRow(row, w, map->ext[1]);
+    nb = extendRow(below, w, map->ext[2]);
+
+    m = 6 * (na + nc + nb) + 3;
+    if (m > map->points_capacity) {
+        for (i = 0; i < 4; i++) {
+            unsigned int capacity = map->points_capacity;
+            map->points[i] = (int*)growArray(map->points[i], &capacity, m, sizeof(int));
+        }
+        map->points_capacity = m;
+    }
+
+    pa = rowPoints(map->ext[0], na, w, map->points[0]);
+    pc = rowPoints(map->ext[1], nc, w, map->points[1]);
+    pb = rowPoints(map->ext[2], nb, w, map->points[2]);
+    m = mergePoints(map->points[0], pa, map->points[1], pc, map->points[2], pb, map->points[3]);
+
+    // Every segment between two points has one state and one count
+    for (i = 0; i < m; i++) {
+
+        x = map->points[3][i];
+        end = (i + 1 < m) ? map->points[3][i + 1] : w;
+        alive = 0;
+        unused = 0;
+
+        count = windowCount(map->ext[1], nc, &cc, x, &alive) - alive;
+        count += windowCount(map->ext[0], na, &ca, x, &unused);
+        count += windowCount(map->ext[2], nb, &cb, x, &unused);
+
+        if (count == 3 || (count == 2 && alive)) appendRun(out, x, end);
+    }
+}
+
+void Intervals_NextGeneration(interval_map* map) {
+
+    interval_row* temp;
+    size_t runs = 0;
+
+    for (unsigned int y = 0; y < map->height; y++) {
+        nextRow(map, y);
+        runs += map->temp_rows[y].count;
+    }
+
+    if (runs > map->peak_runs) map->peak_runs = runs;
+
+    temp = map->rows;
+    map->rows = map->temp_rows;
+    map->temp_rows = temp;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameIntervals(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    interval_map map;
+
+    Intervals_Init(&map, width, height);
+    life106_read_file_intervals(input_field_filename, &map);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        Intervals_NextGeneration(&map);
+    }
+
+    clock_t end = clock();
+
+    printf("// Intervals: %zu runs at peak\n", map.peak_runs);
+
+    life106_save_file_intervals(output_field_filename, &map);
+
+    Intervals_Release(&map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+// Live cells start .. end - 1 of a row, wrapped copies may reach -1 and width
+typedef struct {
+    int start;
+    int end;
+} interval;
+
+// Sorted, disjoint and non-adjacent runs of one row
+typedef struct {
+    interval* runs;
+    unsigned int count;
+    unsigned int capacity;
+} interval_row;
+
+/*
+* Run-length field: memory grows with the number of live runs, not with
+* width * height, so very wide sparse fields fit. The scratch buffers are
+* sized for the busiest row seen so far.
+*/
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    interval_row* rows;
+    interval_row* temp_rows;
+    interval* ext[3];           // rows y - 1, y and y + 1 with their wrapped runs
+    unsigned int ext_capacity;
+    int* points[4];             // segment starts of the three rows and their merge
+    unsigned int points_capacity;
+    size_t peak_runs;
+} interval_map;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameIntervals(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+void Intervals_Init(interval_map* map, unsigned width, unsigned height);
+void Intervals_Release(interval_map* map);
+void Intervals_SetCell(interval_map* map, unsigned int x, unsigned int y);
+void Intervals_NextGeneration(interval_map* map);
@@ -10,29 +10,23 @@
 #include <string.h>
 
 #include "mem_optimized.h"
-
-typedef struct
-{
-	int x;
-	int y;
-} coordinate;
-
-void life106_read_file(const char* filename, field_t* field)
+#include "bitboard.h"
+#include "qlife.h"
+#include "hashlife.h"
+#include "sparse.h"
+#include "intervals.h"
+#include "batch.h"
+
+unsigned life106_read_coordinates(const char* filename, coordinate** coordinates)
 {
-	// delete everything in the field
-	for_yx(field->height, field->width)
-	{
-		field->rows[y][x] = 0;
-	}
-	//
 	char* file_content = read_file(filename);
 	char** lines = NULL;
 	unsigned lines_count = string_split(file_content, "\r\n", &lines);
 
 	// parse coordinates
 	unsigned coordinates_count = 0;
-	coordinate* coordinates = malloc(sizeof(coordinate) * lines_count);
-	if (coordinates == NULL) error("Can't allocate memory for coordinates!");
+	*coordinates = malloc(sizeof(coordinate) * lines_count);
+	if (*coordinates == NULL) error("Can't allocate memory for coordinates!");
 
 	for_i(i, lines_count)
 	{
@@ -48,30 +42,29 @@ void life106_read_file(const char* filename, field_t* field)
 		int x = strtol(coordinate_splits[0], NULL, 0);
 		int y = strtol(coordinate_splits[1], NULL, 0);
 
-		coordinates[coordinates_count++] = (coordinate){ .x = x, .y = y };
+		(*coordinates)[coordinates_count++] = (coordinate){ .x = x, .y = y };
+		free(coordinate_splits);
 	}
 
-	// read coordinates to field
-	unsigned offset_x = field->width / 2;
-	unsigned offset_y = field->height / 2;
-	for_i(i, coordinates_count)
-	{
-		coordinate current_coordinate = coordinates[i];
+	free(lines);
+	free(file_content);
 
-		// move coordinate by half of the field dimensions
-		int y = current_coordinate.y + offset_y;
-		int x = current_coordinate.x + offset_x;
+	return coordinates_count;
+}
 
-		// skip coordinate if it is outside the field
-		if (y < 0 || y >= field->height || x < 0 || x >= field->width) continue;
+/*
+* Move a coordinate by half of the field dimensions. Returns 0 if it lies
+* outside the field; a negative position wraps to a large unsigned value.
+*/
+int life106_place(coordinate c, unsigned width, unsigned height, unsigned* x, unsigned* y)
+{
+	*x = (unsigned)c.x + width / 2;
+	*y = (unsigned)c.y + height / 2;
 
-		field->rows[y][x] = 1;
-	}
-	
-	free(file_content);
+	return *x < width && *y < height;
 }
 
-void life106_save_file(const char* filename, field_t* field)
+FILE* life106_create_file(const char* filename)
 {
 	FILE* file = NULL;
 	errno_t error_number = fopen_s(&file, filename, "wb");
@@ -79,9 +72,39 @@ void life106_save_file(const char* filename, field_t* field)
 
 	fprintf(file, "#Life 1.06\r\n");
 
+	return file;
+}
+
+void life106_read_file(const char* filename, field_t* field)
+{
+	// delete everything in the field
+	for_i(y, field->height)
+	{
+		memset(field_row(field, y), 0, field->width);
+	}
+	//
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
+	// read coordinates to field
+	unsigned x, y;
+	for_i(i, coordinates_count)
+	{
+		// skip coordinate if it is outside the field
+		if (!life106_place(coordinates[i], field->width, field->height, &x, &y)) continue;
+		field_row(field, y)[x] = 1;
+	}
+
+	free(coordinates);
+}
+
+void life106_save_file(const char* filename, field_t* field)
+{
+	FILE* file = life106_create_file(filename);
+
 	for_yx(field->height, field->width)
 	{
-		if (field->rows[y][x] == 1)
+		if (field_row(field, y)[x] == 1)
 		{
 			fprintf(file, "%i %i\r\n", x, y);
 		}
@@ -92,79 +115,286 @@ void life106_save_file(const char* filename, field_t* field)
 // =================================================
 //
 //						MEMORY
-// 
+//
 // =================================================
 
 void life106_read_file_memory(const char* filename, cell* field){
 
-	char* file_content = read_file(filename);
-	char** lines = NULL;
-	unsigned lines_count = string_split(file_content, "\r\n", &lines);
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
 
-	// parse coordinates
-	unsigned coordinates_count = 0;
-	coordinate* coordinates = malloc(sizeof(coordinate) * lines_count);
-	if (coordinates == NULL) error("Can't allocate memory for coordinates!");
+	// read coordinates to field
+	unsigned x, y;
+	for_i(i, coordinates_count)
+	{
+		// skip coordinate if it is outside the field
+		if (!life106_place(coordinates[i], field->width, field->height, &x, &y)) continue;
+		setCell(*field, x, y);
+	}
 
-	for_i(i, lines_count)
+	free(coordinates);
+}
+
+void life106_save_file_memory(const char* filename, cell* field){
+	FILE* file = life106_create_file(filename);
+
+	for_i(y, field->height)
 	{
-		char* current_line = lines[i];
-		if (current_line[0] == '#') continue; // skip comments
+		unsigned char* row = field->ptr + y * field->stride;
 
-		// split coordinate
-		char** coordinate_splits;
-		unsigned coordinate_splits_count = string_split(current_line, " ", &coordinate_splits);
-		if (coordinate_splits_count != 2) error("Invalid Life 1.06 file!");
+		for_i(x, field->width)
+		{
+			if (row[x] & 0x01) {
+				fprintf(file, "%i %i\r\n", x, y);
+			}
+		}
+	}
 
-		// parse coordinate
-		int x = strtol(coordinate_splits[0], NULL, 0);
-		int y = strtol(coordinate_splits[1], NULL, 0);
+	fclose(file);
+}
+
+// =================================================
+//
+//						BITMAP
+//
+// =================================================
+
+void life106_read_file_bitmap(const char* filename, bitmap* field){
 
-		coordinates[coordinates_count++] = (coordinate){ .x = x, .y = y };
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
+	// read coordinates to field
+	unsigned x, y;
+	for_i(i, coordinates_count)
+	{
+		// skip coordinate if it is outside the field
+		if (!life106_place(coordinates[i], field->width, field->height, &x, &y)) continue;
+		setBit(*field, x, y);
 	}
 
+	free(coordinates);
+}
+
+void life106_save_file_bitmap(const char* filename, bitmap* field){
+	FILE* file = life106_create_file(filename);
+
+	for_i(y, field->height)
+	{
+		uint64_t* row = field->rows + (size_t)y * field->stride + 1;
+
+		for_i(i, field->words)
+		{
+			uint64_t word = row[i];
+			if (i == field->words - 1) word &= field->last_mask;
+
+			// emit set bits from lowest to highest x
+			while (word) {
+				fprintf(file, "%u %u\r\n", i * 64 + ctz64(word), y);
+				word &= word - 1;
+			}
+		}
+	}
+
+	fclose(file);
+}
+
+// =================================================
+//
+//						QLIFE
+//
+// =================================================
+
+void life106_read_file_qlife(const char* filename, qlife_map* field){
+
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
 	// read coordinates to field
-	unsigned offset_x = field->width / 2;
-	unsigned offset_y = field->height / 2;
+	unsigned x, y;
 	for_i(i, coordinates_count)
 	{
-		coordinate current_coordinate = coordinates[i];
+		// skip coordinate if it is outside the field
+		if (!life106_place(coordinates[i], field->width, field->height, &x, &y)) continue;
+		QLife_SetCell(field, x, y);
+	}
 
-		// move coordinate by half of the field dimensions
-		int y = current_coordinate.y + offset_y;
-		int x = current_coordinate.x + offset_x;
+	free(coordinates);
+}
+
+void life106_save_file_qlife(const char* filename, qlife_map* field){
+	FILE* file = life106_create_file(filename);
 
+	for_i(y, field->height)
+	{
+		uint16_t* row = field->cells + y * field->words;
+
+		for_i(x, field->width)
+		{
+			if ((row[x / 3] >> (x % 3)) & 1) {
+				fprintf(file, "%i %i\r\n", x, y);
+			}
+		}
+	}
+
+	fclose(file);
+}
+
+// =================================================
+//
+//						HASHLIFE
+//
+// =================================================
+
+void life106_read_file_hashlife(const char* filename, hashlife* field){
+
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
+	// read coordinates to field
+	unsigned x, y;
+	for_i(i, coordinates_count)
+	{
 		// skip coordinate if it is outside the field
-		if (y < 0 || y >= field->height || x < 0 || x >= field->width) continue;
-		setCell(*field, x, y);
+		if (!life106_place(coordinates[i], field->size, field->size, &x, &y)) continue;
+		HashLife_SetCell(field, x, y);
 	}
 
-	free(file_content);
+	free(coordinates);
 }
 
-void life106_save_file_memory(const char* filename, cell* field){
-	FILE* file = NULL;
-	errno_t error_number = fopen_s(&file, filename, "wb");
-	if (error_number != 0 || file == NULL) error("Can't open file!");
+void life106_save_file_hashlife(const char* filename, hashlife* field){
+	FILE* file = life106_create_file(filename);
+	uint64_t* cells = NULL;
+	size_t cells_count = HashLife_Cells(field, &cells);
 
-	int x = 0;
-	int y = 0;
+	for_i(i, cells_count)
+	{
+		fprintf(file, "%u %u\r\n", (unsigned)(cells[i] & 0xFFFFFFFF), (unsigned)(cells[i] >> 32));
+	}
 
-	fprintf(file, "#Life 1.06\r\n");
+	free(cells);
+	fclose(file);
+}
+
+// =================================================
+//
+//						SPARSE
+//
+// =================================================
+
+void life106_read_file_sparse(const char* filename, sparse_map* field){
+
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
+	// the plane has no border, every coordinate is kept
+	for_i(i, coordinates_count)
+	{
+		coordinate current_coordinate = coordinates[i];
+
+		Sparse_SetCell(field, (int64_t)current_coordinate.x + field->offset_x, (int64_t)current_coordinate.y + field->offset_y);
+	}
+
+	free(coordinates);
+}
+
+void life106_save_file_sparse(const char* filename, sparse_map* field){
+	FILE* file = life106_create_file(filename);
 
-	for (int i = 0; i < field->size; i++) {
+	for_i(i, field->tile_count)
+	{
+		const sparse_tile* tile = field->tiles[i];
 
-		if (x >= field->width) {
-			x = 0;
-			y++;
+		for_i(r, SPARSE_TILE)
+		{
+			for (uint64_t row = tile->rows[r]; row != 0; row &= row - 1)
+			{
+				long long x = (long long)tile->tx * SPARSE_TILE + ctz64(row);
+				long long y = (long long)tile->ty * SPARSE_TILE + r;
+				fprintf(file, "%lld %lld\r\n", x, y);
+			}
 		}
+	}
+	fclose(file);
+}
 
-		if (*(field->ptr + i) & 0x01) {
-			fprintf(file, "%i %i\r\n", x, y);
+// =================================================
+//
+//						INTERVALS
+//
+// =================================================
+
+void life106_read_file_intervals(const char* filename, interval_map* field){
+
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
+	// read coordinates to field
+	unsigned x, y;
+	for_i(i, coordinates_count)
+	{
+		// skip coordinate if it is outside the field
+		if (!life106_place(coordinates[i], field->width, field->height, &x, &y)) continue;
+		Intervals_SetCell(field, x, y);
+	}
+
+	free(coordinates);
+}
+
+void life106_save_file_intervals(const char* filename, interval_map* field){
+	FILE* file = life106_create_file(filename);
+
+	for_i(y, field->height)
+	{
+		const interval_row* row = field->rows + y;
+
+		for_i(i, row->count)
+		{
+			for (int x = row->runs[i].start; x < row->runs[i].end; x++)
+			{
+				fprintf(file, "%i %u\r\n", x, y);
+			}
 		}
+	}
+	fclose(file);
+}
 
-		x++;
+// =================================================
+//
+//						BATCH
+//
+// =================================================
+
+void life106_read_file_batch(const char* filename, batch_map* field, unsigned int lane){
+
+	coordinate* coordinates = NULL;
+	unsigned coordinates_count = life106_read_coordinates(filename, &coordinates);
+
+	// read coordinates to lane of the field
+	unsigned x, y;
+	for_i(i, coordinates_count)
+	{
+		// skip coordinate if it is outside the field
+		if (!life106_place(coordinates[i], field->width, field->height, &x, &y)) continue;
+		Batch_SetCell(field, x, y, lane);
+	}
+
+	free(coordinates);
+}
+
+void life106_save_file_batch(const char* filename, batch_map* field, unsigned int lane){
+	FILE* file = life106_create_file(filename);
+
+	for_i(y, field->height)
+	{
+		const uint64_t* row = field->cells + (size_t)y * field->stride;
+
+		for_i(x, field->width)
+		{
+			if ((row[x] >> lane) & 1) fprintf(file, "%u %u\r\n", x, y);
+		}
 	}
 
 	fclose(file);
-}
\ No newline at end of file
+}
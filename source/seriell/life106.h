@@ -1,7 +1,27 @@
 #pragma once
 
+#include <stdio.h>
+
 #include "field.h"
 #include "mem_optimized.h"
+#include "bitboard.h"
+#include "qlife.h"
+#include "hashlife.h"
+#include "sparse.h"
+#include "intervals.h"
+#include "batch.h"
+
+// =================================================
+//
+//                  STRUCTURES
+// 
+// =================================================
+
+typedef struct
+{
+	int x;
+	int y;
+} coordinate;
 
 // =================================================
 //
@@ -9,7 +29,22 @@
 // 
 // =================================================
 
+unsigned life106_read_coordinates(const char* filename, coordinate** coordinates);
+int life106_place(coordinate c, unsigned width, unsigned height, unsigned* x, unsigned* y);
+FILE* life106_create_file(const char* filename);
 void life106_read_file(const char* filename, field_t* field);
 void life106_save_file(const char* filename, field_t* field);
 void life106_read_file_memory(const char* filename, cell* field);
 void life106_save_file_memory(const char* filename, cell* field);
+void life106_read_file_bitmap(const char* filename, bitmap* field);
+void life106_save_file_bitmap(const char* filename, bitmap* field);
+void life106_read_file_qlife(const char* filename, qlife_map* field);
+void life106_save_file_qlife(const char* filename, qlife_map* field);
+void life106_read_file_hashlife(const char* filename, hashlife* field);
+void life106_save_file_hashlife(const char* filename, hashlife* field);
+void life106_read_file_sparse(const char* filename, sparse_map* field);
+void life106_save_file_sparse(const char* filename, sparse_map* field);
+void life106_read_file_intervals(const char* filename, interval_map* field);
+void life106_save_file_intervals(const char* filename, interval_map* field);
+void life106_read_file_batch(const char* filename, batch_map* field, unsigned int lane);
+void life106_save_file_batch(const char* filename, batch_map* field, unsigned int lane);
@@ -0,0 +1,163 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Lookup table engine on the bitboard layout: the 4x4 neighbourhood of a
+* 2x2 block is a 16-bit index into a 64K table of the four next states.
+* No counting and no branch per cell.
+*
+* Referenzen:
+* Game Of Life:   https://github.com/jagregory/abrash-black-book (Chapter 18)
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "lut.h"
+#include "bitboard.h"
+#include "life106.h"
+
+/*
+* Index bits 4r..4r+3 are the columns x-1..x+2 of row y-1+r, the result
+* bits 0/1 are (x, y)/(x+1, y) and bits 2/3 are (x, y+1)/(x+1, y+1).
+*/
+static uint8_t block_table[1 << 16];
+
+static void buildTable(void) {
+
+    static int built = 0;
+    unsigned int index, bx, by, dx, dy, n, alive;
+    uint8_t result;
+
+    if (built) return;
+
+    for (index = 0; index < (1 << 16); index++) {
+
+        result = 0;
+        for (by = 1; by <= 2; by++) {
+            for (bx = 1; bx <= 2; bx++) {
+
+                n = 0;
+                for (dy = by - 1; dy <= by + 1; dy++)
+                    for (dx = bx - 1; dx <= bx + 1; dx++)
+                        n += (index >> (4 * dy + dx)) & 1;
+
+                alive = (index >> (4 * by + bx)) & 1;
+                n -= alive;
+                if (n == 3 || (n == 2 && alive)) result |= (uint8_t)(1 << ((by - 1) * 2 + (bx - 1)));
+            }
+        }
+        block_table[index] = result;
+    }
+
+    built = 1;
+}
+
+/*
+* Cells x-1..x+2 of a wrapped row (see wrapRow). x is even, so the four bits
+* cross into the next word only when x-1 is one of its last three bits.
+*/
+static inline unsigned int nibble(const uint64_t* row, unsigned int x) {
+
+    unsigned int bit = x + 63;  // x - 1, counted from the left ghost word
+    unsigned int word = bit >> 6, shift = bit & 63;
+    uint64_t bits = row[word] >> shift;
+
+    if (shift > 60) bits |= row[word + 1] << (64 - shift);
+
+    return (unsigned int)bits & 0x0F;
+}
+
+/*
+* Rows y and y+1 of the next generation from rows y-1..y+2, taken mod h.
+* With an odd height the last band only keeps its upper row.
+*/
+static void lookupBand(bitmap* map, unsigned int y) {
+
+    unsigned int i, x, end, index, result;
+    unsigned int h = map->height, w = map->width, stride = map->stride;
+    const uint64_t* r0 = map->rows + (size_t)((y == 0) ? h - 1 : y - 1) * stride;
+    const uint64_t* r1 = map->rows + (size_t)y * stride;
+    const uint64_t* r2 = map->rows + (size_t)((y + 1) % h) * stride;
+    const uint64_t* r3 = map->rows + (size_t)((y + 2) % h) * stride;
+    uint64_t* top = map->temp_rows + (size_t)y * stride;
+    uint64_t* bottom = (y + 1 < h) ? map->temp_rows + (size_t)(y + 1) * stride : NULL;
+    uint64_t upper, lower;
+
+    for (i = 0; i < map->words; i++) {
+
+        upper = 0;
+        lower = 0;
+        end = (i * 64 + 64 < w) ? i * 64 + 64 : w;
+
+        for (x = i * 64; x < end; x += 2) {
+
+            index = nibble(r0, x) | (nibble(r1, x) << 4) | (nibble(r2, x) << 8) | (nibble(r3, x) << 12);
+            result = block_table[index];
+
+            upper |= (uint64_t)(result & 3) << (x & 63);
+            lower |= (uint64_t)(result >> 2) << (x & 63);
+        }
+
+        if (i == map->words - 1) {
+            upper &= map->last_mask;
+            lower &= map->last_mask;
+        }
+
+        top[1 + i] = upper;
+        if (bottom != NULL) bottom[1 + i] = lower;
+    }
+}
+
+static void nextGenerationLookup(bitmap* map) {
+
+    unsigned int y;
+    uint64_t* temp;
+
+    for (y = 0; y < map->height; y++) {
+        wrapRow(map->rows + (size_t)y * map->stride, map->width, map->words);
+    }
+
+    for (y = 0; y < map->height; y += 2) {
+        lookupBand(map, y);
+    }
+
+    temp = map->rows;
+    map->rows = map->temp_rows;
+    map->temp_rows = temp;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameLookup(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    bitmap map;
+
+    buildTable();
+
+    map = BitMap_Init(width, height);
+    life106_read_file_bitmap(input_field_filename, &map);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        nextGenerationLookup(&map);
+    }
+
+    clock_t end = clock();
+
+    life106_save_file_bitmap(output_field_filename, &map);
+
+    BitMap_Release(map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -10,11 +10,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 /* User defined headers */
 #include "mem_optimized.h"
 #include "life106.h"
+#include "cycle.h"
+#include "options.h"
 
 void* xmalloc(size_t bytes) {
 
@@ -27,36 +30,114 @@ void* xmalloc(size_t bytes) {
     return buffer;
 }
 
+/*
+* The count maps carry a one-cell ghost border, so the eight neighbours are
+* always at the same offsets. Counts that land in the border are folded
+* back onto the opposite edge once per generation by foldBorder.
+*/
 void _helperCell(cell Cell, unsigned int x, unsigned int y, signed int neighbor) {
 
-    int w = Cell.width, h = Cell.height, size = Cell.size;
-    int xoleft, xoright, yoabove, yobelow;
-    int offset = (y * w) + x;
-    unsigned char* cell_ptr = Cell.ptr + offset;
-
-    // Calculate the offsets to the eight neighboring cells,
-    // accounting for wrapping around at the edges of the cell map
-    xoleft = (x == 0) ? w - 1 : -1;
-    xoright = (x == (w - 1)) ? -(w - 1) : 1;
-    yoabove = (y == 0) ? size - w : -w;
-    yobelow = (y == (h - 1)) ? -(size - w) : w;
+    int s = Cell.stride;
+    unsigned char* cell_ptr = Cell.ptr + (y * s) + x;
 
     if (neighbor < 0) {
         *(cell_ptr) &= ~0x01;   // Set first bit to 0
+        countLive(Cell.live, x, y, 0);
     }
     else {
         *(cell_ptr) |= 0x01;    // Set first bit to 1
+        countLive(Cell.live, x, y, 1);
     }
 
     // Change successive bits for neighbour counts
-    *(cell_ptr + yoabove + xoleft) += neighbor;
-    *(cell_ptr + yoabove) += neighbor;
-    *(cell_ptr + yoabove + xoright) += neighbor;
-    *(cell_ptr + xoleft) += neighbor;
-    *(cell_ptr + xoright) += neighbor;
-    *(cell_ptr + yobelow + xoleft) += neighbor;
-    *(cell_ptr + yobelow) += neighbor;
-    *(cell_ptr + yobelow + xoright) += neighbor;
+    *(cell_ptr - s - 1) += neighbor;
+    *(cell_ptr - s) += neighbor;
+    *(cell_ptr - s + 1) += neighbor;
+    *(cell_ptr - 1) += neighbor;
+    *(cell_ptr + 1) += neighbor;
+    *(cell_ptr + s - 1) += neighbor;
+    *(cell_ptr + s) += neighbor;
+    *(cell_ptr + s + 1) += neighbor;
+}
+
+/*
+* Add the ghost border onto the opposite edge of the torus and clear it.
+* Columns are folded first, including the ghost rows, so the corner counts
+* travel on into the ghost rows and reach the opposite corner with the rows.
+*/
+static void foldTorus(cell Cell) {
+
+    int x, y;
+    int w = Cell.width, h = Cell.height, s = Cell.stride;
+    unsigned char* row;
+    unsigned char* top = Cell.ptr - s;
+    unsigned char* bottom = Cell.ptr + h * s;
+
+    for (y = -1; y <= h; y++) {
+        row = Cell.ptr + y * s;
+        row[w - 1] += row[-1];
+        row[0] += row[w];
+        row[-1] = 0;
+        row[w] = 0;
+    }
+
+    for (x = 0; x < w; x++) {
+        *(Cell.ptr + (h - 1) * s + x) += top[x];
+        *(Cell.ptr + x) += bottom[x];
+        top[x] = 0;
+        bottom[x] = 0;
+    }
+}
+
+// Nothing lies beyond the edge: the counts in the border are dropped
+static void foldDead(cell Cell) {
+
+    int y;
+    int w = Cell.width, h = Cell.height, s = Cell.stride;
+
+    memset(Cell.ptr - s - 1, 0, w + 2);
+    memset(Cell.ptr + h * s - 1, 0, w + 2);
+
+    for (y = 0; y < h; y++) {
+        Cell.ptr[y * s - 1] = 0;
+        Cell.ptr[y * s + w] = 0;
+    }
+}
+
+/*
+* Klein bottle: the columns fold as on the torus, the ghost rows land on
+* the opposite edge with x mirrored. The corners take the same path as in
+* foldTorus and end up on the mirrored opposite corner.
+*/
+static void foldKlein(cell Cell) {
+
+    int x, y;
+    int w = Cell.width, h = Cell.height, s = Cell.stride;
+    unsigned char* row;
+    unsigned char* top = Cell.ptr - s;
+    unsigned char* bottom = Cell.ptr + h * s;
+
+    for (y = -1; y <= h; y++) {
+        row = Cell.ptr + y * s;
+        row[w - 1] += row[-1];
+        row[0] += row[w];
+        row[-1] = 0;
+        row[w] = 0;
+    }
+
+    for (x = 0; x < w; x++) {
+        *(Cell.ptr + (h - 1) * s + (w - 1 - x)) += top[x];
+        *(Cell.ptr + (w - 1 - x)) += bottom[x];
+        top[x] = 0;
+        bottom[x] = 0;
+    }
+}
+
+void foldBorder(cell Cell) {
+
+    if (Cell.boundary == BOUNDARY_DEAD) foldDead(Cell);
+    else if (Cell.boundary == BOUNDARY_KLEIN) foldKlein(Cell);
+    else foldTorus(Cell);
 }
 
 void setCell(cell Cell, unsigned int x, unsigned int y) {
@@ -71,50 +152,504 @@ void deleteCell(cell Cell, unsigned int x, unsigned int y) {
     _helperCell(Cell, x, y, decrease_neighbor);
 }
 
-void nextGeneration(cell Cell) {
+void appendChange(change_list* list, unsigned int x, unsigned int y) {
 
-    unsigned int x, y, count;
-    unsigned int h = Cell.height, w = Cell.width;
-    unsigned char* cell_ptr;
+    if (list->count == list->capacity) {
+        list->capacity = (list->capacity == 0) ? 1024 : list->capacity * 2;
+        list->items = (cell_change*)realloc(list->items, list->capacity * sizeof(cell_change));
+        if (list->items == NULL) {
+            fprintf(stderr, "Allocation error...\n");
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    memcpy(Cell.temp_ptr, Cell.ptr, Cell.size);
-    cell_ptr = Cell.temp_ptr;
+    list->items[list->count].x = x;
+    list->items[list->count].y = y;
+    list->count++;
+}
 
-    for (y = 0; y < h; y++) {
+/*
+* Bring the previous count map up to the current generation by flipping
+* the cells changed last generation; the state bit in the old map tells
+* whether the flip was a birth or a death.
+*/
+void replayChanges(cell* Cell) {
 
-        x = 0;
-        do {
+    cell prev = *Cell;
+    prev.ptr = Cell->temp_ptr;
+    prev.live = Cell->temp_live;
 
-            // Zero bytes are off and have no neighbours so skip them...
-            while (*cell_ptr == 0) {
-                cell_ptr++; // Advance to the next cell
-                // If all cells in row are off with no neighbours go to next row
-                if (++x >= w) goto RowDone;
-            }
+    for (unsigned int i = 0; i < Cell->changes.count; i++) {
 
-            // Remaining cells are either on or have neighbours
-            count = *cell_ptr >> 1; // # of neighboring on-cells
-            if (*cell_ptr & 0x01) {
+        unsigned int x = Cell->changes.items[i].x;
+        unsigned int y = Cell->changes.items[i].y;
 
-                // On cell must turn off if not 2 or 3 neighbours
-                if ((count != 2) && (count != 3)) {
-                    deleteCell(Cell, x, y);
-                }
-            }
-            else {
+        if (*(prev.ptr + (y * prev.stride) + x) & 0x01) {
+            deleteCell(prev, x, y);
+        }
+        else {
+            setCell(prev, x, y);
+        }
+    }
+}
+
+/*
+* A tile can only change if a cell in it or in one of its eight neighbour
+* tiles (torus) flipped last generation. Without wrap the extra tiles only
+* cost a scan. Fills tile_active for tile row ty;
+* frozen tiles are replayed instead.
+*/
+static void activeTiles(cell* Cell, unsigned int ty) {
+
+    unsigned int tx, nx = Cell->tiles_x, ny = Cell->tiles_y;
+    const unsigned char* above = Cell->tiles + ((ty == 0) ? ny - 1 : ty - 1) * nx;
+    const unsigned char* middle = Cell->tiles + ty * nx;
+    const unsigned char* below = Cell->tiles + ((ty == ny - 1) ? 0 : ty + 1) * nx;
+    unsigned char* column = Cell->tile_active + nx;
+
+    unsigned char mirrored = 0;
+
+    // On the Klein bottle the wrapped tile row comes back mirrored and the
+    // tiles need not line up, so a flip anywhere in it wakes the whole row
+    if (Cell->boundary == BOUNDARY_KLEIN && (ty == 0 || ty == ny - 1)) {
+        const unsigned char* wrapped = (ty == 0) ? above : below;
+        for (tx = 0; tx < nx; tx++) mirrored |= wrapped[tx];
+        mirrored &= TILE_CHANGED;
+    }
+
+    for (tx = 0; tx < nx; tx++) {
+        column[tx] = ((above[tx] | middle[tx] | below[tx]) & TILE_CHANGED) | mirrored;
+    }
+
+    for (tx = 0; tx < nx; tx++) {
+        Cell->tile_active[tx] = column[(tx == 0) ? nx - 1 : tx - 1] | column[tx] | column[(tx == nx - 1) ? 0 : tx + 1];
+        if (middle[tx] & TILE_FROZEN) Cell->tile_active[tx] = 0;
+    }
+}
+
+// TILE_NEXT becomes TILE_CHANGED for the next generation
+static void ageTiles(cell* Cell) {
+
+    for (unsigned int i = 0; i < Cell->tiles_x * Cell->tiles_y; i++) {
+        Cell->tiles[i] = (Cell->tiles[i] & TILE_FROZEN) | ((Cell->tiles[i] >> 1) & TILE_CHANGED);
+    }
+}
+
+// =================================================
+//
+//                  OSCILLATING TILES
+//
+// =================================================
+
+// Cells on the outermost row or column of their tile, the ring of the next tile
+static inline int onTileEdge(const cell* Cell, unsigned int x, unsigned int y) {
+    return ((x + 1) & (TILE_SIZE - 1)) <= 1 || ((y + 1) & (TILE_SIZE - 1)) <= 1
+        || x == Cell->width - 1 || y == Cell->height - 1;
+}
+
+// (x, y) came alive: tiles that have it in their ring stop after this generation
+static void thawNeighbours(cell* Cell, unsigned int x, unsigned int y) {
+
+    unsigned int w = Cell->width, h = Cell->height, nx = Cell->tiles_x;
+    unsigned int own = (y >> TILE_SHIFT) * nx + (x >> TILE_SHIFT);
+    unsigned int xs[3], ys[3], i, j, t;
+
+    xs[0] = (x == 0) ? w - 1 : x - 1;
+    xs[1] = x;
+    xs[2] = (x == w - 1) ? 0 : x + 1;
+    ys[0] = (y == 0) ? h - 1 : y - 1;
+    ys[1] = y;
+    ys[2] = (y == h - 1) ? 0 : y + 1;
+
+    for (j = 0; j < 3; j++) {
+        for (i = 0; i < 3; i++) {
+            t = (ys[j] >> TILE_SHIFT) * nx + (xs[i] >> TILE_SHIFT);
+            if (t != own && Cell->cycles[t].state != CYCLE_FREE) Cell->cycles[t].thaw = 1;
+        }
+    }
+}
+
+/*
+* Write a flip of (x, y) into next and keep the books: change list, tile
+* hash, recorded phases and tile flags. Flips inside a frozen tile cannot
+* reach the neighbour tiles, so only its edge flips wake them up.
+*/
+static void flipCell(cell* Cell, cell next, unsigned int x, unsigned int y, int born) {
+
+    unsigned int t = (y >> TILE_SHIFT) * Cell->tiles_x + (x >> TILE_SHIFT);
+    tile_cycle* tile = Cell->cycles + t;
+    int edge = onTileEdge(Cell, x, y);
+
+    if (born) setCell(next, x, y);
+    else deleteCell(next, x, y);
+
+    appendChange(&Cell->next_changes, x, y);
+    tile->hash ^= cycleKey(x, y, Cell->width);
+
+    if (tile->state == CYCLE_RECORDING) appendChange(&tile->flips, x, y);
+    if (!(Cell->tiles[t] & TILE_FROZEN) || edge) Cell->tiles[t] |= TILE_NEXT;
+    if (born && edge) thawNeighbours(Cell, x, y);
+}
+
+// Next phase of every frozen tile
+static void replayFrozen(cell* Cell, cell next) {
+
+    unsigned int i, j, x, y;
+    tile_cycle* tile;
+
+    for (i = 0; i < Cell->watched_count; i++) {
+
+        tile = Cell->cycles + Cell->watched[i];
+        if (tile->state != CYCLE_FROZEN) continue;
+
+        for (j = tile->start[tile->phase]; j < tile->start[tile->phase + 1]; j++) {
+            x = tile->flips.items[j].x;
+            y = tile->flips.items[j].y;
+            flipCell(Cell, next, x, y, !(*(Cell->ptr + y * Cell->stride + x) & 0x01));
+        }
+    }
+}
+
+// No live cell in the ring of cells around tile t
+static int ringDead(const cell* Cell, unsigned int t) {
+
+    unsigned int w = Cell->width, h = Cell->height;
+    unsigned int x0 = (t % Cell->tiles_x) << TILE_SHIFT, y0 = (t / Cell->tiles_x) << TILE_SHIFT;
+    unsigned int x1 = (x0 + TILE_SIZE < w) ? x0 + TILE_SIZE : w;
+    unsigned int y1 = (y0 + TILE_SIZE < h) ? y0 + TILE_SIZE : h;
+    unsigned int left = (x0 == 0) ? w - 1 : x0 - 1, right = (x1 == w) ? 0 : x1;
+    unsigned int top = (y0 == 0) ? h - 1 : y0 - 1, bottom = (y1 == h) ? 0 : y1;
+    unsigned int x, y;
+
+    for (x = x0; x < x1; x++) {
+        if ((*(Cell->ptr + top * Cell->stride + x) | *(Cell->ptr + bottom * Cell->stride + x)) & 0x01) return 0;
+    }
+    for (y = top, x = 0; x < y1 - y0 + 2; x++, y = (y == h - 1) ? 0 : y + 1) {
+        if ((*(Cell->ptr + y * Cell->stride + left) | *(Cell->ptr + y * Cell->stride + right)) & 0x01) return 0;
+    }
+
+    return 1;
+}
+
+/*
+* Store the tile hash of generation g. History entries are only written
+* for tiles that flipped, the generations in between had the last hash.
+*/
+static void rememberHash(tile_cycle* tile, unsigned int g) {
+
+    uint64_t previous = tile->history[tile->last % TILE_PERIODS];
+    unsigned int k = (g - tile->last > TILE_PERIODS) ? g - TILE_PERIODS : tile->last + 1;
+
+    for (; k < g; k++) tile->history[k % TILE_PERIODS] = previous;
+
+    tile->history[g % TILE_PERIODS] = tile->hash;
+    tile->last = g;
+}
+
+// Advance a recording or frozen tile, 0 once it is scanned again
+static int advanceWatched(cell* Cell, unsigned int t, unsigned int g) {
+
+    tile_cycle* tile = Cell->cycles + t;
+
+    rememberHash(tile, g);
+
+    if (tile->thaw) {
+        tile->thaw = 0;
+        tile->state = CYCLE_FREE;
+        Cell->tiles[t] = (Cell->tiles[t] & ~TILE_FROZEN) | TILE_CHANGED;
+        return 0;
+    }
+
+    if (tile->state == CYCLE_FROZEN) {
+        if (++tile->phase == tile->period) tile->phase = 0;
+        return 1;
+    }
+
+    tile->start[++tile->phase] = tile->flips.count;
+    if (tile->phase < tile->period) return 1;
+
+    // Back in the recorded state: the phases repeat for as long as the ring stays dead
+    tile->phase = 0;
+    if (tile->hash != tile->history[(g - tile->period) % TILE_PERIODS]) {
+        tile->state = CYCLE_FREE;
+        return 0;
+    }
+
+    tile->state = CYCLE_FROZEN;
+    Cell->tiles[t] |= TILE_FROZEN;
+    return 1;
+}
+
+/*
+* End of a generation: advance recording and frozen tiles and start
+* recording tiles whose hash repeats. Runs after ageTiles, so
+* TILE_CHANGED marks the tiles flipped this generation.
+*/
+static void trackTiles(cell* Cell) {
+
+    unsigned int i, p, t, g = ++Cell->generation;
+    tile_cycle* tile;
+
+    // The rings of ringDead and thawNeighbours do not follow the mirrored edge
+    if (Cell->boundary == BOUNDARY_KLEIN) return;
+
+    for (i = 0; i < Cell->watched_count;) {
+        if (advanceWatched(Cell, Cell->watched[i], g)) i++;
+        else Cell->watched[i] = Cell->watched[--Cell->watched_count];
+    }
+
+    for (t = 0; t < Cell->tiles_x * Cell->tiles_y; t++) {
+
+        if (!(Cell->tiles[t] & TILE_CHANGED)) continue;
+
+        tile = Cell->cycles + t;
+        if (tile->state != CYCLE_FREE) continue;
+
+        rememberHash(tile, g);
+
+        // Smallest period the hash repeats with
+        for (p = 2; p < TILE_PERIODS && p <= g; p++) {
+            if (tile->history[(g - p) % TILE_PERIODS] == tile->hash) break;
+        }
+
+        if (p < TILE_PERIODS && p <= g && ringDead(Cell, t)) {
+            tile->state = CYCLE_RECORDING;
+            tile->period = (unsigned char)p;
+            tile->phase = 0;
+            tile->start[0] = 0;
+            tile->flips.count = 0;
+            Cell->watched[Cell->watched_count++] = t;
+        }
+    }
+}
+
+/*
+* Scan row y between x_begin and x_end, over the runs of active tiles only,
+* and write the flips into next. flips is the RULE_FLIPS mask of the rule.
+*/
+static inline void scanSpanRule(cell* Cell, cell next, unsigned int y, unsigned int x_begin, unsigned int x_end, const uint32_t flips) {
+
+    unsigned int x, tx, run, x_stop;
+    unsigned char* row = Cell->ptr + y * Cell->stride;
+
+    for (tx = x_begin >> TILE_SHIFT; tx < Cell->tiles_x && (tx << TILE_SHIFT) < x_end; tx = run) {
+
+        if (!Cell->tile_active[tx]) {
+            run = tx + 1;
+            continue;
+        }
+        for (run = tx + 1; run < Cell->tiles_x && Cell->tile_active[run]; run++);
+        x_stop = (run << TILE_SHIFT < x_end) ? run << TILE_SHIFT : x_end;
+        x = (tx << TILE_SHIFT > x_begin) ? tx << TILE_SHIFT : x_begin;
+
+        // Zero bytes are off and have no neighbours so skip them...
+        for (x = nextNonZero(row, x, x_stop); x < x_stop; x = nextNonZero(row, x + 1, x_stop)) {
+
+            // Remaining cells are either on or have neighbours, state and
+            // count together select the bit of the flip mask
+            if ((flips >> row[x]) & 1) flipCell(Cell, next, x, y, !(row[x] & 0x01));
+        }
+    }
+}
+
+typedef void (*scan_span_fn)(cell* Cell, cell next, unsigned int y, unsigned int x_begin, unsigned int x_end);
+
+#define SCAN_SPAN_RULE(id, text, birth, survive) \
+    static void scanSpan##id(cell* Cell, cell next, unsigned int y, unsigned int x_begin, unsigned int x_end) { \
+        scanSpanRule(Cell, next, y, x_begin, x_end, RULE_FLIPS(birth, survive)); \
+    }
+#define SCAN_SPAN_ENTRY(id, text, birth, survive) scanSpan##id,
+
+LIFE_RULES(SCAN_SPAN_RULE)
+
+static const scan_span_fn scanSpanKernels[] = { LIFE_RULES(SCAN_SPAN_ENTRY) };
+
+static uint32_t customFlips;
+
+static void scanSpanCustom(cell* Cell, cell next, unsigned int y, unsigned int x_begin, unsigned int x_end) {
+    scanSpanRule(Cell, next, y, x_begin, x_end, customFlips);
+}
+
+// Kernel of the rule in gameOptions, chosen by selectScanSpan
+static scan_span_fn scanSpan = scanSpanLife;
 
-                // Off cell must turn on if 3 neighbours
-                if (count == 3) {
-                    setCell(Cell, x, y);
-                }
+void selectScanSpan(const life_rule* rule) {
+
+    int index = ruleIndex(rule);
+
+    customFlips = RULE_FLIPS(rule->birth, rule->survive);
+    scanSpan = (index == RULE_CUSTOM) ? scanSpanCustom : scanSpanKernels[index];
+}
+
+void nextGeneration(cell* Cell) {
+
+    unsigned int i, y, ty = (unsigned int)-1;
+    unsigned int h = Cell->height, w = Cell->width;
+    unsigned int y_first, rows, x_first, columns;
+    unsigned char* temp;
+    live_cells* temp_live;
+    live_cells* live = Cell->live;
+    change_list list;
+    cell next;
+
+    // The other buffer becomes the next generation: catch it up with the
+    // current one instead of copying the whole map
+    replayChanges(Cell);
+
+    next = *Cell;
+    next.ptr = Cell->temp_ptr;
+    next.live = Cell->temp_live;
+    Cell->next_changes.count = 0;
+
+    replayFrozen(Cell, next);
+
+    // Bounding box of the live cells plus one cell, wrapped around the torus
+    if (live->x0 <= live->x1) {
+        y_first = (live->y0 == 0) ? h - 1 : (unsigned int)(live->y0 - 1);
+        rows = (live->y1 - live->y0 + 3 < (int)h) ? (unsigned int)(live->y1 - live->y0 + 3) : (unsigned int)h;
+        x_first = (live->x0 == 0) ? w - 1 : (unsigned int)(live->x0 - 1);
+        columns = (live->x1 - live->x0 + 3 < (int)w) ? (unsigned int)(live->x1 - live->x0 + 3) : (unsigned int)w;
+
+        // Across a mirrored edge the neighbours can lie anywhere in the row
+        if (Cell->boundary == BOUNDARY_KLEIN && (live->y0 == 0 || live->y1 == (int)h - 1)) {
+            x_first = 0;
+            columns = w;
+        }
+    }
+    else {
+        y_first = x_first = 0;
+        rows = columns = 0;
+    }
+
+    for (i = 0; i < rows; i++) {
+
+        y = (y_first + i < h) ? y_first + i : y_first + i - h;
+
+        if ((y >> TILE_SHIFT) != ty) {
+            ty = y >> TILE_SHIFT;
+            activeTiles(Cell, ty);
+        }
+
+        // No live cell on or next to this row: every count byte is zero
+        if (rowsLive(Cell, y) == 0) continue;
+
+        if (x_first + columns <= w) {
+            scanSpan(Cell, next, y, x_first, x_first + columns);
+        }
+        else {
+            scanSpan(Cell, next, y, x_first, w);
+            scanSpan(Cell, next, y, 0, x_first + columns - w);
+        }
+    }
+
+    ageTiles(Cell);
+    foldBorder(next);
+
+    // Swap buffers: the written map is the new generation
+    temp = Cell->ptr;
+    Cell->ptr = Cell->temp_ptr;
+    Cell->temp_ptr = temp;
+
+    temp_live = Cell->live;
+    Cell->live = Cell->temp_live;
+    Cell->temp_live = temp_live;
+
+    list = Cell->changes;
+    Cell->changes = Cell->next_changes;
+    Cell->next_changes = list;
+
+    trackTiles(Cell);
+}
+
+// =================================================
+//
+//                  CHANGE LIST
+//
+// =================================================
+
+/*
+* Put (x, y) and its eight torus neighbours on the candidate list. The
+* CANDIDATE bit in the count byte keeps every cell on the list only once.
+*/
+static void markNeighbourhood(cell* Cell, unsigned int x, unsigned int y) {
+
+    unsigned int w = Cell->width, h = Cell->height;
+    unsigned int xs[3], ys[3];
+    unsigned char* cell_ptr;
+
+    xs[0] = (x == 0) ? w - 1 : x - 1;
+    xs[1] = x;
+    xs[2] = (x == w - 1) ? 0 : x + 1;
+    ys[0] = (y == 0) ? h - 1 : y - 1;
+    ys[1] = y;
+    ys[2] = (y == h - 1) ? 0 : y + 1;
+
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 3; i++) {
+            cell_ptr = Cell->ptr + ys[j] * Cell->stride + xs[i];
+            if (!(*cell_ptr & CANDIDATE)) {
+                *cell_ptr |= CANDIDATE;
+                appendChange(&Cell->candidates, xs[i], ys[j]);
             }
+        }
+    }
+}
+
+/*
+* Only cells next to a flip of the last generation can change, so only
+* those are evaluated. All flips are collected first and then applied to
+* the one map, which makes the second buffer unnecessary. The work per
+* generation follows the activity instead of the field area.
+*/
+void nextGenerationChangeList(cell* Cell) {
+
+    unsigned int i, x, y, count;
+    unsigned char* cell_ptr;
+    change_list list;
 
-            // Advance to the next cell byte
-            cell_ptr++;
+    Cell->candidates.count = 0;
+    Cell->next_changes.count = 0;
 
-        } while (++x < w);
-    RowDone:;
+    for (i = 0; i < Cell->changes.count; i++) {
+        markNeighbourhood(Cell, Cell->changes.items[i].x, Cell->changes.items[i].y);
     }
+
+    for (i = 0; i < Cell->candidates.count; i++) {
+
+        x = Cell->candidates.items[i].x;
+        y = Cell->candidates.items[i].y;
+        cell_ptr = Cell->ptr + y * Cell->stride + x;
+
+        *cell_ptr &= ~CANDIDATE;
+        count = *cell_ptr >> 1; // # of neighboring on-cells
+
+        if (*cell_ptr & 0x01) {
+            if ((count != 2) && (count != 3)) appendChange(&Cell->next_changes, x, y);
+        }
+        else {
+            if (count == 3) appendChange(&Cell->next_changes, x, y);
+        }
+    }
+
+    // Every cell is on the list once, so its state bit is still the old one
+    for (i = 0; i < Cell->next_changes.count; i++) {
+
+        x = Cell->next_changes.items[i].x;
+        y = Cell->next_changes.items[i].y;
+
+        if (*(Cell->ptr + y * Cell->stride + x) & 0x01) {
+            deleteCell(*Cell, x, y);
+        }
+        else {
+            setCell(*Cell, x, y);
+        }
+    }
+
+    foldBorder(*Cell);
+
+    list = Cell->changes;
+    Cell->changes = Cell->next_changes;
+    Cell->next_changes = list;
 }
 
 unsigned int seed;
@@ -133,41 +668,237 @@ void fillMap(cell Cell, unsigned int w, unsigned int h) {
     } while (--init_length);
 }
 
+// No live cell, the bounding box empty
+static void liveReset(live_cells* live, unsigned int width, unsigned int height) {
+
+    memset(live->rows, 0, height * sizeof(unsigned int));
+    memset(live->columns, 0, width * sizeof(unsigned int));
+
+    live->x0 = live->y0 = 0;
+    live->x1 = live->y1 = -1;
+}
+
+static live_cells* liveInit(unsigned int width, unsigned int height) {
+
+    live_cells* live = (live_cells*)xmalloc(sizeof(live_cells));
+
+    live->rows = (unsigned int*)xmalloc(height * sizeof(unsigned int));
+    live->columns = (unsigned int*)xmalloc(width * sizeof(unsigned int));
+    liveReset(live, width, height);
+
+    return live;
+}
+
+static void liveRelease(live_cells* live) {
+    free(live->rows);
+    free(live->columns);
+    free(live);
+}
+
+void GameMap_Init(cell* map, unsigned width, unsigned height) {
+
+    // Interior plus ghost border; the slack lets nextNonZero read past the last row
+    unsigned int stride = width + 2;
+    size_t bytes = (size_t)stride * (height + 2) + SCAN_BYTES;
+
+    map->width = width;
+    map->height = height;
+    map->stride = stride;
+    map->size = width * height;
+    map->boundary = gameOptions.boundary;
+    map->ptr = (unsigned char*)xmalloc(bytes) + stride + 1;
+    map->temp_ptr = (unsigned char*)xmalloc(bytes) + stride + 1;
+
+    map->live = liveInit(width, height);
+    map->temp_live = liveInit(width, height);
+
+    map->tiles_x = (width + TILE_SIZE - 1) >> TILE_SHIFT;
+    map->tiles_y = (height + TILE_SIZE - 1) >> TILE_SHIFT;
+    map->tiles = (unsigned char*)xmalloc(map->tiles_x * map->tiles_y);
+    map->tile_active = (unsigned char*)xmalloc(2 * map->tiles_x);
+    map->cycles = (tile_cycle*)xmalloc(map->tiles_x * map->tiles_y * sizeof(tile_cycle));
+    memset(map->cycles, 0, map->tiles_x * map->tiles_y * sizeof(tile_cycle));
+    map->watched = (unsigned int*)xmalloc(map->tiles_x * map->tiles_y * sizeof(unsigned int));
+
+    memset(&map->changes, 0, sizeof(change_list));
+    memset(&map->next_changes, 0, sizeof(change_list));
+    memset(&map->candidates, 0, sizeof(change_list));
+
+    GameMap_Reset(map);
+}
+
+/*
+* Empty field of the same size, ready for the next pattern. Every buffer
+* is kept, including the grown change lists and recorded tile flips, so a
+* map can serve one field after another without allocating.
+*/
+void GameMap_Reset(cell* map) {
+
+    size_t bytes = (size_t)map->stride * (map->height + 2) + SCAN_BYTES;
+    unsigned int tiles = map->tiles_x * map->tiles_y;
+    change_list flips;
+
+    memset(map->ptr - map->stride - 1, 0, bytes);
+    memset(map->temp_ptr - map->stride - 1, 0, bytes);
+    liveReset(map->live, map->width, map->height);
+    liveReset(map->temp_live, map->width, map->height);
+
+    // Every tile takes part in the first generation
+    memset(map->tiles, TILE_CHANGED, tiles);
+    for (unsigned int t = 0; t < tiles; t++) {
+        flips = map->cycles[t].flips;
+        flips.count = 0;
+        memset(map->cycles + t, 0, sizeof(tile_cycle));
+        map->cycles[t].flips = flips;
+    }
+    map->watched_count = 0;
+    map->generation = 0;
+
+    map->changes.count = 0;
+    map->next_changes.count = 0;
+    map->candidates.count = 0;
+}
+
+/*
+* Called once the initial pattern is in ptr: folds the border written by
+* setCell and marks every live cell as changed, so the first replay builds
+* the second map from the empty one. Also hashes the tiles.
+*/
+void GameMap_Start(cell* map) {
+
+    unsigned int x, y;
+    unsigned char* cell_ptr;
+
+    foldBorder(*map);
+    map->changes.count = 0;
+
+    for (y = 0; y < map->height; y++) {
+        cell_ptr = map->ptr + y * map->stride;
+        for (x = 0; x < map->width; x++) {
+            if (cell_ptr[x] & 0x01) {
+                appendChange(&map->changes, x, y);
+                map->cycles[(y >> TILE_SHIFT) * map->tiles_x + (x >> TILE_SHIFT)].hash ^= cycleKey(x, y, map->width);
+            }
+        }
+    }
+
+    for (x = 0; x < map->tiles_x * map->tiles_y; x++) {
+        map->cycles[x].history[0] = map->cycles[x].hash;
+    }
+}
+
+void GameMap_Release(cell* map) {
+    free(map->ptr - map->stride - 1);
+    free(map->temp_ptr - map->stride - 1);
+    liveRelease(map->live);
+    liveRelease(map->temp_live);
+    free(map->tiles);
+    free(map->tile_active);
+    for (unsigned int i = 0; i < map->tiles_x * map->tiles_y; i++) free(map->cycles[i].flips.items);
+    free(map->cycles);
+    free(map->watched);
+    free(map->changes.items);
+    free(map->next_changes.items);
+    free(map->candidates.items);
+}
+
 // =================================================
 //
 //                  GAME OF LIFE
 // 
 // =================================================
 
+// Flip the cells of the last generation in the field hash
+static uint64_t hashChanges(const cell* map, uint64_t hash) {
+
+    for (unsigned int i = 0; i < map->changes.count; i++) {
+        hash ^= cycleKey(map->changes.items[i].x, map->changes.items[i].y, map->width);
+    }
+
+    return hash;
+}
+
+/*
+* frames generations of a map after GameMap_Start. With -cycle the run ends
+* early once the field repeats, on a generation equivalent to frames.
+* Returns the generations computed; *period is the period found or 0.
+*/
+unsigned int GameMap_Run(cell* map, unsigned int frames, unsigned int* period) {
+
+    cycle_history history;
+    uint64_t hash = 0;
+
+    *period = 0;
+
+    // GameMap_Start lists every live cell as changed, so the same fold
+    // gives the hash of the start field
+    if (gameOptions.cycle) {
+        Cycle_Init(&history);
+        hash = hashChanges(map, hash);
+        frames = Cycle_Skip(&history, hash, 0, frames);
+    }
+
+    for (unsigned int i = 0; i < frames; i++) {
+        nextGeneration(map);
+
+        if (gameOptions.cycle) {
+            hash = hashChanges(map, hash);
+            frames = Cycle_Skip(&history, hash, i + 1, frames);
+        }
+    }
+
+    if (gameOptions.cycle) {
+        *period = history.period;
+        Cycle_Release(&history);
+    }
+
+    return frames;
+}
+
 double GameSeriell(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
 
     cell map;
-    unsigned int size = width * height;
-    char* cells = (char*)xmalloc(size);
-    char* temp = (char*)xmalloc(size);
-    
-    map.width = width;
-    map.height = height;
-    map.size = size;
-    map.ptr = cells;
-    map.temp_ptr = temp;
-
-    memset(cells, 0, size);
-    
+    unsigned int period;
+
+    GameMap_Init(&map, width, height);
     life106_read_file_memory(input_field_filename, &map);
+    GameMap_Start(&map);
+    selectScanSpan(&gameOptions.rule);
 
     clock_t start = clock();
 
-    for (int i = 0; i < frames; i++) {
-        nextGeneration(map);
+    frames = GameMap_Run(&map, frames, &period);
+
+    clock_t end = clock();
+
+    if (period) printf("// Cycle of period %u, stopped after %u generations\n", period, frames);
+
+    life106_save_file_memory(output_field_filename, &map);
+
+    GameMap_Release(&map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
+
+double GameChangeList(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    cell map;
+
+    GameMap_Init(&map, width, height);
+    life106_read_file_memory(input_field_filename, &map);
+    GameMap_Start(&map);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        nextGenerationChangeList(&map);
     }
 
     clock_t end = clock();
 
     life106_save_file_memory(output_field_filename, &map);
 
-    free(cells);
-    free(temp);
+    GameMap_Release(&map);
 
     return (double)(end - start) / (double)CLOCKS_PER_SEC;
 }
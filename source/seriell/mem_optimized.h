@@ -1,25 +1,197 @@
 #pragma once
 
+#include <stddef.h>
+#include <string.h>
+
+#include "utils.h"
+#include "cycle.h"
+#include "rule.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Bytes the count-map scan tests per step; also the slack behind each map
+#define SCAN_BYTES 16
+
+// Tiles of TILE_SIZE x TILE_SIZE cells; flags of the tile map
+#define TILE_SHIFT      6
+#define TILE_SIZE       (1 << TILE_SHIFT)
+#define TILE_CHANGED    0x01    // a cell of the tile flipped last generation
+#define TILE_NEXT       0x02    // a cell of the tile flipped this generation
+#define TILE_FROZEN     0x04    // oscillating tile, replayed instead of scanned
+
+// Oscillator detection per tile: hashes kept and states of a tile
+#define TILE_PERIODS    32      // periods 2 .. TILE_PERIODS - 1 are detected
+#define CYCLE_FREE      0       // scanned
+#define CYCLE_RECORDING 1       // scanned, flips are recorded for one period
+#define CYCLE_FROZEN    2       // not scanned, the recorded flips are replayed
+
+// Spare bit of a count byte: cell is already on the change-list candidates
+#define CANDIDATE 0x80
+
 // =================================================
 //
 //                  STRUCTURES
 // 
 // =================================================
 
+typedef struct {
+    unsigned int x;
+    unsigned int y;
+} cell_change;
+
+typedef struct {
+    cell_change* items;
+    unsigned int count;
+    unsigned int capacity;
+} change_list;
+
+/*
+* A tile whose hash repeats after p generations records its flips for p
+* more generations. If it is then back in the same state and no cell of the
+* ring around it came alive meanwhile, it evolves on its own: it is frozen
+* and the recorded phases are replayed instead of scanning it. A birth in
+* the ring sends the tile back to scanning after the running generation.
+*/
+typedef struct {
+    uint64_t hash;                      // XOR of cycleKey over the live cells
+    uint64_t history[TILE_PERIODS];     // hash after generation g at g % TILE_PERIODS
+    unsigned int last;                  // generation of the newest history entry
+    unsigned char state;
+    unsigned char period;
+    unsigned char phase;                // phases recorded, or phase to replay next
+    unsigned char thaw;                 // ring cell born, back to CYCLE_FREE
+    unsigned int start[TILE_PERIODS];   // phase i owns flips start[i] .. start[i + 1] - 1
+    change_list flips;
+} tile_cycle;
+
+/*
+* Live cells of one count map per row and per column, and the bounding box
+* they span. The box only grows in setCell; deleteCell moves an edge inward
+* once its row or column runs empty.
+*/
+typedef struct {
+    unsigned int* rows;
+    unsigned int* columns;
+    int x0, y0;                 // bounding box, inclusive;
+    int x1, y1;                 // empty when x0 > x1
+} live_cells;
+
+/*
+* Two count maps are used ping-pong: ptr holds the current generation,
+* temp_ptr the previous one. temp_ptr lags behind by exactly the cells in
+* changes, which are replayed into it before it receives the next generation.
+* Both maps have a one-cell ghost border: ptr points at cell (0, 0) and
+* rows are stride = width + 2 bytes apart. live belongs to ptr and temp_live
+* to temp_ptr, so the scan can pass over empty rows and outside the box.
+* tiles flags the tiles with flips, so it can pass over stable regions.
+*/
 typedef struct {
     unsigned int width;
     unsigned int height;
+    unsigned int stride;
     unsigned int size;
+    int boundary;               // BOUNDARY_* of gameOptions, applied by foldBorder
     unsigned char* ptr;
     unsigned char* temp_ptr;
+    live_cells* live;
+    live_cells* temp_live;
+    unsigned int tiles_x;
+    unsigned int tiles_y;
+    unsigned char* tiles;       // TILE_CHANGED / TILE_NEXT / TILE_FROZEN per tile
+    unsigned char* tile_active; // tiles to scan in the current tile row
+    tile_cycle* cycles;         // oscillator detection per tile
+    unsigned int* watched;      // tiles recording or frozen
+    unsigned int watched_count;
+    unsigned int generation;
+    change_list changes;        // cells flipped by the last generation
+    change_list next_changes;   // cells flipped by the running generation
+    change_list candidates;     // cells evaluated by the change-list engine
 } cell;
 
+/*
+* Index of the first non-zero count byte at or after x, or a value >= w if
+* the rest of the row is zero. Tests SCAN_BYTES bytes per step; the loads may
+* run into the ghost border and the next row, which GameMap_Init pads for.
+*/
+static inline unsigned int nextNonZero(const unsigned char* row, unsigned int x, unsigned int w) {
+
+#ifdef SCAN_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    unsigned int mask;
+
+    for (; x < w; x += 16) {
+        mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(row + x)), zero)) & 0xFFFF;
+        if (mask) return x + ctz64(mask);
+    }
+#else
+    uint64_t word;
+
+    for (; x < w; x += 8) {
+        memcpy(&word, row + x, sizeof(word));
+        if (word) return x + (ctz64(word) >> 3);   // little endian: lowest set byte first
+    }
+#endif
+
+    return x;
+}
+
+// Live cells in row y and its two neighbouring rows of the torus
+static inline unsigned int rowsLive(const cell* Cell, unsigned int y) {
+
+    unsigned int above = (y == 0) ? Cell->height - 1 : y - 1;
+    unsigned int below = (y == Cell->height - 1) ? 0 : y + 1;
+
+    return Cell->live->rows[above] + Cell->live->rows[y] + Cell->live->rows[below];
+}
+
+// Count a birth (born != 0) or death at (x, y) and keep the bounding box tight
+static inline void countLive(live_cells* live, unsigned int x, unsigned int y, int born) {
+
+    if (born) {
+        live->rows[y]++;
+        live->columns[x]++;
+
+        if (live->x0 > live->x1) {
+            live->x0 = live->x1 = (int)x;
+            live->y0 = live->y1 = (int)y;
+            return;
+        }
+        if ((int)x < live->x0) live->x0 = (int)x;
+        if ((int)x > live->x1) live->x1 = (int)x;
+        if ((int)y < live->y0) live->y0 = (int)y;
+        if ((int)y > live->y1) live->y1 = (int)y;
+    }
+    else {
+        live->rows[y]--;
+        live->columns[x]--;
+
+        while (live->y0 <= live->y1 && live->rows[live->y0] == 0) live->y0++;
+        while (live->y0 <= live->y1 && live->rows[live->y1] == 0) live->y1--;
+        while (live->x0 <= live->x1 && live->columns[live->x0] == 0) live->x0++;
+        while (live->x0 <= live->x1 && live->columns[live->x1] == 0) live->x1--;
+    }
+}
+
 // =================================================
 //
 //              FUNCTION PROTOTYPES
 // 
 // =================================================
 
+void* xmalloc(size_t bytes);
 double GameSeriell(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+double GameChangeList(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+void GameMap_Init(cell* map, unsigned width, unsigned height);
+void GameMap_Reset(cell* map);
+void GameMap_Release(cell* map);
+void GameMap_Start(cell* map);
+unsigned int GameMap_Run(cell* map, unsigned int frames, unsigned int* period);
+void selectScanSpan(const life_rule* rule);
+void nextGeneration(cell* Cell);
+void nextGenerationChangeList(cell* Cell);
+void foldBorder(cell Cell);
 void setCell(cell Cell, unsigned int x, unsigned int y);
 void deleteCell(cell Cell, unsigned int x, unsigned int y);
\ No newline at end of file
@@ -0,0 +1,148 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Job pool: a list of (input, frames, output) jobs runs on the count map
+* of GameSeriell, spread over a pool of OpenMP threads. Every thread keeps
+* one map for the whole run and resets it between its jobs, so the field
+* buffers are allocated once per thread instead of once per job. Without
+* OpenMP the pragmas are ignored and the jobs run one after another.
+*
+* Referenzen:
+* OpenMP: https://www.openmp.org/specifications/
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* User defined headers */
+#include "pool.h"
+#include "mem_optimized.h"
+#include "life106.h"
+#include "options.h"
+#include "file_utils.h"
+#include "string_utils.h"
+#include "utils.h"
+
+// Wall clock, clock() would add up the time of all threads
+static double wallTime(void) {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+// Threads of the pool, 1 without OpenMP
+int Pool_Threads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/*
+* One job per line: <input.lif> <frames> <output.lif>, lines starting
+* with '#' are comments. The paths point into *content, which the caller
+* frees together with *jobs.
+*/
+static unsigned int readJobList(const char* filename, char** content, pool_job** jobs) {
+
+    char** lines = NULL;
+    char** fields = NULL;
+    unsigned int lines_count, count = 0;
+
+    *content = read_file(filename);
+    lines_count = string_split(*content, "\r\n", &lines);
+    *jobs = (pool_job*)xmalloc(lines_count * sizeof(pool_job));
+
+    for (unsigned int i = 0; i < lines_count; i++) {
+
+        if (lines[i][0] == '#') continue;
+
+        if (string_split(lines[i], " \t", &fields) != 3) error("Invalid job! Expected <input.lif> <frames> <output.lif>");
+
+        (*jobs)[count].input = fields[0];
+        (*jobs)[count].frames = (unsigned int)strtoul(fields[1], NULL, 10);
+        (*jobs)[count].output = fields[2];
+        if ((*jobs)[count].frames == 0) error("Frames must be a positive number!");
+
+        count++;
+        free(fields);
+    }
+
+    free(lines);
+
+    if (count == 0) error("The job list holds no job!");
+
+    return count;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+/*
+* input_field_filename is the job list, every field has width x height
+* cells. The whole run is timed, reading and writing the fields included,
+* as it replaces one process per field. The frames and output arguments
+* are unused, every job brings its own.
+*/
+double GamePool(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    char* content;
+    pool_job* jobs;
+    unsigned int count;
+    unsigned long long generations = 0;
+    int threads = Pool_Threads();
+    double start, seconds;
+
+    (void)frames;
+    (void)output_field_filename;
+
+    count = readJobList(input_field_filename, &content, &jobs);
+    selectScanSpan(&gameOptions.rule);
+
+    start = wallTime();
+
+#pragma omp parallel num_threads(threads) reduction(+:generations)
+    {
+        cell map;
+        unsigned int period;
+
+        GameMap_Init(&map, width, height);
+
+        // Jobs can differ a lot in frames, so they are handed out one by one
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < (int)count; i++) {
+            GameMap_Reset(&map);
+            life106_read_file_memory(jobs[i].input, &map);
+            GameMap_Start(&map);
+            generations += GameMap_Run(&map, jobs[i].frames, &period);
+            life106_save_file_memory(jobs[i].output, &map);
+        }
+
+        GameMap_Release(&map);
+    }
+
+    seconds = wallTime() - start;
+
+    printf("// Pool: %u boards on %i threads, %.0f boards/s, %.0f generations/s\n",
+        count, threads, (seconds > 0) ? count / seconds : 0.0, (seconds > 0) ? generations / seconds : 0.0);
+
+    free(jobs);
+    free(content);
+
+    return seconds;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+// One line of the job list: <input.lif> <frames> <output.lif>
+typedef struct {
+    char* input;
+    char* output;
+    unsigned int frames;
+} pool_job;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+int Pool_Threads(void);
+double GamePool(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
@@ -0,0 +1,276 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* QLIFE: three cells and their neighbour counts share one 16-bit word, the
+* next state of all three is one lookup in a 32K table. Only words whose
+* counts or states changed are evaluated again.
+*
+* Referenzen:
+* Game Of Life:   https://github.com/jagregory/abrash-black-book (Chapter 17, 18)
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "qlife.h"
+#include "mem_optimized.h"
+#include "life106.h"
+#include "utils.h"
+
+// Next states of the three cells for every state/count combination
+static uint8_t next_states[QLIFE_INDEX + 1];
+
+static void buildTable(void) {
+
+    static int built = 0;
+    unsigned int index, slot, alive, count;
+    uint8_t states;
+
+    if (built) return;
+
+    for (index = 0; index <= QLIFE_INDEX; index++) {
+
+        states = 0;
+        for (slot = 0; slot < 3; slot++) {
+            alive = (index >> slot) & 1;
+            count = (index >> (3 + 4 * slot)) & 0x0F;
+            if (count == 3 || (count == 2 && alive)) states |= (uint8_t)(1 << slot);
+        }
+        next_states[index] = states;
+    }
+
+    built = 1;
+}
+
+void QLife_Init(qlife_map* map, unsigned width, unsigned height) {
+
+    size_t total;
+
+    buildTable();
+
+    map->width = width;
+    map->height = height;
+    map->words = (width + 2) / 3;
+    map->last_states = (uint16_t)((1u << (width - 3 * (map->words - 1))) - 1);
+
+    total = (size_t)map->words * height;
+    map->cells = (uint16_t*)xmalloc(total * sizeof(uint16_t));
+    memset(map->cells, 0, total * sizeof(uint16_t));
+
+    // The lists start empty and grow on demand
+    map->changed = NULL;
+    map->listed = NULL;
+    map->flips = NULL;
+    map->changed_count = map->changed_capacity = 0;
+    map->listed_count = map->listed_capacity = 0;
+    map->flips_capacity = 0;
+}
+
+void QLife_Release(qlife_map* map) {
+    free(map->cells);
+    free(map->changed);
+    free(map->listed);
+    free(map->flips);
+}
+
+// Double the capacity of a word or flip list
+static void* growList(void* items, unsigned int* capacity, size_t size) {
+
+    *capacity = (*capacity == 0) ? 1024 : *capacity * 2;
+    items = realloc(items, *capacity * size);
+    if (items == NULL) {
+        fprintf(stderr, "Allocation error...\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return items;
+}
+
+static inline void addCount(qlife_map* map, unsigned int index, uint16_t value) {
+
+    map->cells[index] += value;
+
+    if (!(map->cells[index] & QLIFE_LISTED)) {
+        if (map->listed_count == map->listed_capacity) {
+            map->listed = (unsigned int*)growList(map->listed, &map->listed_capacity, sizeof(unsigned int));
+        }
+        map->cells[index] |= QLIFE_LISTED;
+        map->listed[map->listed_count++] = index;
+    }
+}
+
+// The words listed so far are evaluated in the next generation
+static void takeListed(qlife_map* map) {
+
+    unsigned int* list = map->changed;
+    unsigned int capacity = map->changed_capacity;
+
+    map->changed = map->listed;
+    map->changed_capacity = map->listed_capacity;
+    map->changed_count = map->listed_count;
+    map->listed = list;
+    map->listed_capacity = capacity;
+    map->listed_count = 0;
+}
+
+/*
+* Add delta (+1 or -1) to the counts of the eight neighbours of (x, y).
+* Away from the left and right edge the three columns are one or two
+* packed adds per row; the edge columns take the torus wrap cell by cell.
+*/
+static void updateNeighbours(qlife_map* map, unsigned int x, unsigned int y, int delta) {
+
+    unsigned int w = map->width, h = map->height, words = map->words;
+    unsigned int word = x / 3, slot = x % 3;
+    unsigned int rows[3];
+    uint16_t column, centre, outer;
+    int j, dx;
+
+    rows[0] = ((y == 0) ? h - 1 : y - 1) * words;
+    rows[1] = y * words;
+    rows[2] = ((y == h - 1) ? 0 : y + 1) * words;
+
+    if (x == 0 || x == w - 1) {
+        for (j = 0; j < 3; j++) {
+            for (dx = -1; dx <= 1; dx++) {
+                if (j == 1 && dx == 0) continue;
+                unsigned int xx = (x + w + dx) % w;
+                addCount(map, rows[j] + xx / 3, (uint16_t)(delta * QLIFE_COUNT(xx % 3)));
+            }
+        }
+        return;
+    }
+
+    // In-word part of the three columns, the own cell only counts above and below
+    column = QLIFE_COUNT(slot);
+    if (slot > 0) column += QLIFE_COUNT(slot - 1);
+    if (slot < 2) column += QLIFE_COUNT(slot + 1);
+    centre = column - QLIFE_COUNT(slot);
+    column = (uint16_t)(delta * column);
+    centre = (uint16_t)(delta * centre);
+
+    addCount(map, rows[0] + word, column);
+    addCount(map, rows[1] + word, centre);
+    addCount(map, rows[2] + word, column);
+
+    // Column in the neighbouring word
+    if (slot == 0) {
+        outer = (uint16_t)(delta * QLIFE_COUNT(2));
+        word--;
+    }
+    else if (slot == 2) {
+        outer = (uint16_t)(delta * QLIFE_COUNT(0));
+        word++;
+    }
+    else {
+        return;
+    }
+
+    for (j = 0; j < 3; j++) {
+        addCount(map, rows[j] + word, outer);
+    }
+}
+
+void QLife_SetCell(qlife_map* map, unsigned int x, unsigned int y) {
+
+    unsigned int index = y * map->words + x / 3;
+    uint16_t bit = (uint16_t)(1 << (x % 3));
+
+    if (map->cells[index] & bit) return;
+
+    map->cells[index] |= bit;
+    addCount(map, index, 0);
+    updateNeighbours(map, x, y, 1);
+}
+
+int QLife_GetCell(const qlife_map* map, unsigned int x, unsigned int y) {
+    return (map->cells[y * map->words + x / 3] >> (x % 3)) & 1;
+}
+
+/*
+* Phase one looks up the new states of all listed words without touching
+* any counts, phase two applies the flips and lists every word it touches
+* for the next generation.
+*/
+void nextGenerationQLife(qlife_map* map) {
+
+    unsigned int i, index, flips, bits, slot, word_x, flip_count = 0;
+    unsigned int last = map->words - 1;
+    uint16_t states;
+
+    for (i = 0; i < map->changed_count; i++) {
+
+        index = map->changed[i];
+        map->cells[index] &= ~QLIFE_LISTED;
+
+        states = next_states[map->cells[index] & QLIFE_INDEX];
+        if (index % map->words == last) states &= map->last_states;
+
+        flips = (states ^ map->cells[index]) & QLIFE_STATES;
+        if (flips) {
+            if (flip_count == map->flips_capacity) {
+                map->flips = (qlife_flip*)growList(map->flips, &map->flips_capacity, sizeof(qlife_flip));
+            }
+            map->flips[flip_count].index = index;
+            map->flips[flip_count].flips = flips;
+            flip_count++;
+        }
+    }
+
+    map->listed_count = 0;
+
+    for (i = 0; i < flip_count; i++) {
+
+        index = map->flips[i].index;
+        flips = map->flips[i].flips;
+        word_x = (index % map->words) * 3;
+
+        for (bits = flips; bits; bits &= bits - 1) {
+
+            slot = ctz64(bits);
+            map->cells[index] ^= (uint16_t)(1 << slot);
+            updateNeighbours(map, word_x + slot, index / map->words, ((map->cells[index] >> slot) & 1) ? 1 : -1);
+        }
+    }
+
+    takeListed(map);
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameQLife(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    qlife_map map;
+    unsigned int i;
+
+    QLife_Init(&map, width, height);
+    life106_read_file_qlife(input_field_filename, &map);
+
+    // The first generation looks at the words around the live cells, all
+    // other words are dead without neighbours and stay dead
+    takeListed(&map);
+
+    clock_t start = clock();
+
+    for (i = 0; i < frames; i++) {
+        nextGenerationQLife(&map);
+    }
+
+    clock_t end = clock();
+
+    life106_save_file_qlife(output_field_filename, &map);
+
+    QLife_Release(&map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
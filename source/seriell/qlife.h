@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+/*
+* Three horizontally adjacent cells per 16-bit word:
+*
+*   bits  0- 2  state of cell 0, 1, 2
+*   bits  3- 6  neighbour count of cell 0
+*   bits  7-10  neighbour count of cell 1
+*   bits 11-14  neighbour count of cell 2
+*   bit     15  word is on the changed list
+*
+* The low 15 bits index the next-state table directly. Slots behind the
+* last cell of a row are padding and never come alive. The word lists grow
+* with the activity, so the field itself costs 16 bits per 3 cells.
+*/
+#define QLIFE_STATES        0x0007
+#define QLIFE_INDEX         0x7FFF
+#define QLIFE_LISTED        0x8000
+#define QLIFE_COUNT(slot)   ((uint16_t)(1u << (3 + 4 * (slot))))
+
+typedef struct {
+    unsigned int index;         // word in cells
+    unsigned int flips;         // state bits that change
+} qlife_flip;
+
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    unsigned int words;         // words per row
+    uint16_t last_states;       // valid state bits of the last word in a row
+    uint16_t* cells;
+    unsigned int* changed;      // words to evaluate in the next generation
+    unsigned int changed_count;
+    unsigned int changed_capacity;
+    unsigned int* listed;       // words collected for the generation after
+    unsigned int listed_count;
+    unsigned int listed_capacity;
+    qlife_flip* flips;
+    unsigned int flips_capacity;
+} qlife_map;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameQLife(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+void QLife_Init(qlife_map* map, unsigned width, unsigned height);
+void QLife_Release(qlife_map* map);
+void QLife_SetCell(qlife_map* map, unsigned int x, unsigned int y);
+int QLife_GetCell(const qlife_map* map, unsigned int x, unsigned int y);
+void nextGenerationQLife(qlife_map* map);
@@ -27,30 +27,93 @@
 *************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
 
 /* User defined headers */
 #include "baseline.h"
 #include "mem_optimized.h"
+#include "bitboard.h"
+#include "qlife.h"
+#include "deferred.h"
+#include "lut.h"
+#include "temporal.h"
+#include "hashlife.h"
+#include "tilecache.h"
+#include "sparse.h"
+#include "intervals.h"
+#include "batch.h"
+#include "pool.h"
+#include "options.h"
 #include "export.h"
 #include "utils.h"
 
 #define NELEMS(x)  (sizeof(x) / sizeof((x)[0]))
 
-int main(int argc, char** argv) {
-	if (argc != 9) error("Arguments: <height> <width> <frames> <input.lif> <output1.lif> <output2.lif> <mode> <new_folder_name>");
+typedef double (*game_fn)(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+
+// HashLife takes the full 64-bit generation count, frames only holds 32 bits
+static unsigned long long generations;
 
-	int process_count = 1;
+// Threads of the running game for the banner and the export, the pool sets its own
+static int threads = 1;
+
+static double GameHashLifeFrames(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+	(void)frames;	// clamped to UINT_MAX, generations holds the real count
+	return GameHashLife(width, height, generations, input_field_filename, output_field_filename);
+}
+
+void runGame(char* title, char* method, game_fn game, unsigned width, unsigned height, unsigned long long frames,
+	char* input_field_filename, char* output_field_filename, char* folder_name) {
+
+	int process_count = threads;
 	int field_size[1];
-	int mode;			// 0: both, 1: baseline, 2: optmzd
-	
-	double start_time;
-	double end_time;
+
 	double duration;
 	double data[1];
 
+	size_t array_size;
+
+	printf("// ================================\n"
+		"//\n"
+		"//	Running %s ...\n"
+		"//	Threads		: %i\n"
+		"//	Frames		: %llu\n"
+		"//	Field		: %ix%i\n"
+		"//	Input  file	: %s\n"
+		"//	Output file	: %s\n"
+		"//\n"
+		"// ================================\n",
+		title,
+		process_count,
+		frames,
+		height,
+		width,
+		input_field_filename,
+		output_field_filename);
+
+	// Only HashLife runs past UINT_MAX frames, it reads generations instead
+	duration = game(width, height, (frames > UINT_MAX) ? UINT_MAX : (unsigned)frames, input_field_filename, output_field_filename);
+
+	printf("// \\\\     //\n");
+	printf("//  \\\\   //\n");
+	printf("//   \\\\_// Duration: %f seconds\n", duration);
+	printf("\n");
+
+	data[0] = duration;
+	field_size[0] = width;
+	array_size = NELEMS(data);
+	exportJson(method, data, array_size, field_size, process_count, frames, folder_name);
+}
+
+int main(int argc, char** argv) {
+	if (argc < 9) error("Arguments: <height> <width> <frames> <input.lif> <output1.lif> <output2.lif> <mode> <new_folder_name> [-cycle] [-rule <Bxx/Syy>] [-boundary <torus|dead|klein>]");
+
+	int mode;			// 0: both, 1: baseline, 2: optmzd, 3: bitboard, 4: baseline vectorized, 5: change list, 6: qlife, 7: deferred, 8: lookup table, 9: temporal blocking, 10: hashlife, 11: tile cache, 12: sparse, 13: intervals, 14: batch, 15: pool
+	const char* kernel;
+
 	unsigned int width;
 	unsigned int height;
-	unsigned int frames;
 
 	char* input_field_filename;
 	char* output_field_filename1;
@@ -59,11 +122,9 @@ int main(int argc, char** argv) {
 	char* export_filename2;
 	char* folder_name;
 
-	size_t array_size;
-
 	width	= atoi(argv[1]);
 	height	= atoi(argv[2]);
-	frames	= atoi(argv[3]);
+	generations = strtoull(argv[3], NULL, 10);
 	input_field_filename	= argv[4];
 	output_field_filename1	= argv[5];
 	output_field_filename2	= argv[6];
@@ -71,10 +132,27 @@ int main(int argc, char** argv) {
 	// export_filename2 = argv[8];
 	mode = atoi(argv[7]);
 	folder_name = argv[8];
+	parseOptions(argc, argv, 9);
 
 	if (height <= 0) error("Height must be a positive number!");
 	if (width <= 0) error("Width must be a positive number!");
-	if (frames <= 0) error("Frames must be a positive number!");
+	if (generations == 0) error("Frames must be a positive number!");
+	if (generations > UINT_MAX && mode != 10) error("Frames above 4294967295 need HashLife (mode 10)!");
+
+	// Other rules only run on the engines with rule kernels
+	if (!ruleIsLife(&gameOptions.rule) && mode != 0 && mode != 1 && mode != 2 && mode != 3 && mode != 9 && mode != 14 && mode != 15)
+		error("Only the modes 0, 1, 2, 3, 9, 14 and 15 support -rule!");
+
+	// Only the count map of GameSeriell looks for cycles, in mode 0 its run
+	if (gameOptions.cycle && mode != 0 && mode != 2 && mode != 15)
+		error("Only the modes 0, 2 and 15 support -cycle!");
+
+	// Other boundaries only run on the engines with boundary kernels
+	if (gameOptions.boundary != BOUNDARY_TORUS && mode != 0 && mode != 1 && mode != 2 && mode != 15)
+		error("Only the modes 0, 1, 2 and 15 support -boundary!");
+
+	// Choose the widest bitboard kernel this CPU can run, or the kernel of the rule
+	kernel = ruleIsLife(&gameOptions.rule) ? bitboardSelectKernel() : bitboardSelectRule(&gameOptions.rule);
 
 	// =================================================
 	// 
@@ -82,34 +160,7 @@ int main(int argc, char** argv) {
 	// 
 	// =================================================
 	if (mode == 0 || mode == 1) {
-		printf("// ================================\n"
-			"//\n"
-			"//	Running Base Game ...\n"
-			"//	Threads		: %i\n"
-			"//	Frames		: %i\n"
-			"//	Field		: %ix%i\n"
-			"//	Input  file	: %s\n"
-			"//	Output file	: %s\n"
-			"//\n"
-			"// ================================\n",
-			process_count,
-			frames,
-			height,
-			width,
-			input_field_filename,
-			output_field_filename1);
-
-		duration = BaseGame(width, height, frames, input_field_filename, output_field_filename1);
-
-		printf("// \\\\     //\n");
-		printf("//  \\\\   //\n");
-		printf("//   \\\\_// Duration: %f seconds\n", duration);
-		printf("\n");
-
-		data[0] = duration;
-		field_size[0] = width;
-		array_size = NELEMS(data);
-		exportJson("seriell", data, array_size, field_size, process_count, frames, folder_name);
+		runGame("Base Game", "seriell", BaseGame, width, height, generations, input_field_filename, output_field_filename1, folder_name);
 	}
 	// =================================================
 	// 
@@ -117,34 +168,127 @@ int main(int argc, char** argv) {
 	// 
 	// =================================================
 	if (mode == 0 || mode == 2) {
-		printf("// ================================\n"
-			"//\n"
-			"//	Running Optimized Game ...\n"
-			"//	Threads		: %i\n"
-			"//	Frames		: %i\n"
-			"//	Field		: %ix%i\n"
-			"//	Input  file	: %s\n"
-			"//	Output file	: %s\n"
-			"//\n"
-			"// ================================\n",
-			process_count,
-			frames,
-			height,
-			width,
-			input_field_filename,
-			output_field_filename2);
-
-		duration = GameSeriell(width, height, frames, input_field_filename, output_field_filename2);
-
-		printf("// \\\\     //\n");
-		printf("//  \\\\   //\n");
-		printf("//   \\\\_// Duration: %f seconds\n", duration);
-		printf("\n");
-
-		data[0] = duration;
-		field_size[0] = width;
-		array_size = NELEMS(data);
-		exportJson("optmzd", data, array_size, field_size, process_count, frames, folder_name);
+		runGame("Optimized Game", "optmzd", GameSeriell, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+	// =================================================
+	// 
+	//	            Bitboard (64 cells per word)
+	// 
+	// =================================================
+	if (mode == 3) {
+		printf("// Bitboard kernel: %s\n", kernel);
+		runGame("Bitboard Game", "bitbrd", GameBitboard, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Base Game (vectorized)
+	// 
+	// =================================================
+	if (mode == 4) {
+		runGame("Base Game (vectorized)", "simd", BaseGameVectorized, width, height, generations, input_field_filename, output_field_filename1, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Change List (active cells only)
+	// 
+	// =================================================
+	if (mode == 5) {
+		runGame("Change List Game", "chglst", GameChangeList, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            QLIFE (3 cells per 16-bit word)
+	// 
+	// =================================================
+	if (mode == 6) {
+		runGame("QLIFE Game", "qlife", GameQLife, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Deferred count updates
+	// 
+	// =================================================
+	if (mode == 7) {
+		runGame("Deferred Game", "dfrrd", GameDeferred, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Lookup table (2x2 blocks)
+	// 
+	// =================================================
+	if (mode == 8) {
+		runGame("Lookup Table Game", "lut", GameLookup, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Temporal blocking (bitboard bands)
+	// 
+	// =================================================
+	if (mode == 9) {
+		printf("// Bitboard kernel: %s\n", kernel);
+		runGame("Temporal Blocking Game", "tmpbl", GameTemporal, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            HashLife (memoised quadtree)
+	// 
+	// =================================================
+	if (mode == 10) {
+		printf("// Generations: %llu\n", generations);
+		runGame("HashLife Game", "hshlf", GameHashLifeFrames, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Tile cache (memoised 16x16 tiles)
+	// 
+	// =================================================
+	if (mode == 11) {
+		runGame("Tile Cache Game", "tlcch", GameTileCache, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Sparse (unbounded plane, hashed tiles)
+	// 
+	// =================================================
+	if (mode == 12) {
+		runGame("Sparse Game", "sparse", GameSparse, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Intervals (run-length rows)
+	// 
+	// =================================================
+	if (mode == 13) {
+		runGame("Intervals Game", "intrvl", GameIntervals, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Batch (64 bit-sliced boards per word)
+	// 
+	// =================================================
+	if (mode == 14) {
+		runGame("Batch Game", "batch", GameBatch, width, height, generations, input_field_filename, output_field_filename2, folder_name);
+	}
+
+	// =================================================
+	// 
+	//	            Pool (job list on a thread pool)
+	// 
+	// =================================================
+	if (mode == 15) {
+		threads = Pool_Threads();
+		runGame("Pool Game", "pool", GamePool, width, height, generations, input_field_filename, output_field_filename2, folder_name);
 	}
 
 	return 0;
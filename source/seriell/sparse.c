@@ -0,0 +1,299 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Unbounded plane: the cells live in 64x64 bitboard tiles that are kept
+* in a hash map keyed by tile coordinate. A tile is allocated as soon as
+* a live cell touches its border and released after it stayed empty for
+* a few generations, so memory and time follow the pattern instead of a
+* pre-sized field. There is no wrap-around, gliders simply fly away.
+*
+* Referenzen:
+* Bitboard:   https://www.chessprogramming.org/General_Setwise_Operations
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "sparse.h"
+#include "bitboard.h"
+#include "mem_optimized.h"
+#include "life106.h"
+
+#define SPARSE_SLOTS        1024    // initial hash map size
+#define SPARSE_IDLE         8       // empty generations before a tile is released
+
+// Tile of a plane coordinate, rounding towards minus infinity
+static inline int32_t tileOf(int64_t v) {
+    return (int32_t)((v < 0) ? -((-v + SPARSE_TILE - 1) / SPARSE_TILE) : v / SPARSE_TILE);
+}
+
+static inline size_t slotOf(const sparse_map* map, int32_t tx, int32_t ty) {
+
+    uint64_t h = ((uint64_t)(uint32_t)ty << 32) | (uint32_t)tx;
+
+    h *= 0x9E3779B97F4A7C15ull;
+    return (size_t)(h ^ (h >> 29)) & (map->slot_count - 1);
+}
+
+static sparse_tile* findTile(const sparse_map* map, int32_t tx, int32_t ty) {
+
+    size_t mask = map->slot_count - 1;
+    sparse_tile* tile;
+
+    for (size_t i = slotOf(map, tx, ty); (tile = map->slots[i]) != NULL; i = (i + 1) & mask) {
+        if (tile->tx == tx && tile->ty == ty) return tile;
+    }
+
+    return NULL;
+}
+
+static void insertSlot(sparse_map* map, sparse_tile* tile) {
+
+    size_t mask = map->slot_count - 1;
+    size_t i = slotOf(map, tile->tx, tile->ty);
+
+    while (map->slots[i] != NULL) i = (i + 1) & mask;
+    map->slots[i] = tile;
+}
+
+static void growSlots(sparse_map* map) {
+
+    map->slot_count *= 2;
+    free(map->slots);
+    map->slots = (sparse_tile**)xmalloc(map->slot_count * sizeof(sparse_tile*));
+    memset(map->slots, 0, map->slot_count * sizeof(sparse_tile*));
+
+    for (size_t i = 0; i < map->tile_count; i++) {
+        insertSlot(map, map->tiles[i]);
+    }
+}
+
+/*
+* Linear probing without tombstones: after removing a slot, every entry of
+* the following cluster that no longer finds its way home is moved up.
+*/
+static void removeSlot(sparse_map* map, const sparse_tile* tile) {
+
+    size_t mask = map->slot_count - 1;
+    size_t i = slotOf(map, tile->tx, tile->ty), j, home;
+
+    while (map->slots[i] != tile) i = (i + 1) & mask;
+    map->slots[i] = NULL;
+
+    for (j = (i + 1) & mask; map->slots[j] != NULL; j = (j + 1) & mask) {
+
+        home = slotOf(map, map->slots[j]->tx, map->slots[j]->ty);
+
+        // Move entry j into the hole unless its home lies in (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            map->slots[i] = map->slots[j];
+            map->slots[j] = NULL;
+            i = j;
+        }
+    }
+}
+
+static sparse_tile* addTile(sparse_map* map, int32_t tx, int32_t ty) {
+
+    sparse_tile* tile = findTile(map, tx, ty);
+
+    if (tile != NULL) return tile;
+
+    tile = (sparse_tile*)xmalloc(sizeof(sparse_tile));
+    memset(tile, 0, sizeof(sparse_tile));
+    tile->tx = tx;
+    tile->ty = ty;
+
+    if (map->tile_count == map->tile_capacity) {
+        map->tile_capacity = (map->tile_capacity == 0) ? 256 : map->tile_capacity * 2;
+        map->tiles = (sparse_tile**)realloc(map->tiles, map->tile_capacity * sizeof(sparse_tile*));
+        if (map->tiles == NULL) {
+            fprintf(stderr, "Allocation error...\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    tile->index = (unsigned int)map->tile_count;
+    map->tiles[map->tile_count++] = tile;
+    if (map->tile_count > map->peak_tiles) map->peak_tiles = map->tile_count;
+
+    if (2 * map->tile_count > map->slot_count) growSlots(map);
+    else insertSlot(map, tile);
+
+    return tile;
+}
+
+static void removeTile(sparse_map* map, sparse_tile* tile) {
+
+    sparse_tile* last = map->tiles[--map->tile_count];
+
+    removeSlot(map, tile);
+    map->tiles[tile->index] = last;
+    last->index = tile->index;
+    free(tile);
+}
+
+void Sparse_Init(sparse_map* map, unsigned width, unsigned height) {
+
+    map->offset_x = (int)(width / 2);
+    map->offset_y = (int)(height / 2);
+    map->slot_count = SPARSE_SLOTS;
+    map->slots = (sparse_tile**)xmalloc(map->slot_count * sizeof(sparse_tile*));
+    memset(map->slots, 0, map->slot_count * sizeof(sparse_tile*));
+    map->tiles = NULL;
+    map->tile_count = 0;
+    map->tile_capacity = 0;
+    map->peak_tiles = 0;
+}
+
+void Sparse_Release(sparse_map* map) {
+
+    for (size_t i = 0; i < map->tile_count; i++) {
+        free(map->tiles[i]);
+    }
+
+    free(map->tiles);
+    free(map->slots);
+}
+
+void Sparse_SetCell(sparse_map* map, int64_t x, int64_t y) {
+
+    int32_t tx = tileOf(x), ty = tileOf(y);
+    sparse_tile* tile = addTile(map, tx, ty);
+
+    tile->rows[y - (int64_t)ty * SPARSE_TILE] |= (uint64_t)1 << (x - (int64_t)tx * SPARSE_TILE);
+}
+
+/*
+* Allocate the neighbours a tile can give birth into: every border with a
+* live cell needs the tile behind it, a live corner also the diagonal one.
+*/
+static void growTile(sparse_map* map, const sparse_tile* tile) {
+
+    int32_t tx = tile->tx, ty = tile->ty;
+    uint64_t top = tile->rows[0], bottom = tile->rows[SPARSE_TILE - 1];
+    uint64_t left = 0, right = 0;
+
+    for (unsigned int r = 0; r < SPARSE_TILE; r++) {
+        left |= tile->rows[r];
+        right |= tile->rows[r];
+    }
+    left &= 1;
+    right >>= 63;
+
+    if (top) addTile(map, tx, ty - 1);
+    if (bottom) addTile(map, tx, ty + 1);
+    if (left) addTile(map, tx - 1, ty);
+    if (right) addTile(map, tx + 1, ty);
+    if (top & 1) addTile(map, tx - 1, ty - 1);
+    if (top >> 63) addTile(map, tx + 1, ty - 1);
+    if (bottom & 1) addTile(map, tx - 1, ty + 1);
+    if (bottom >> 63) addTile(map, tx + 1, ty + 1);
+}
+
+/*
+* Next generation of one tile into tile->next. The tile is padded to 66
+* rows with the facing rows of the tiles above and below, the columns left
+* and right of it only contribute one bit per row.
+*/
+static int stepTile(const sparse_map* map, sparse_tile* tile) {
+
+    int32_t tx = tile->tx, ty = tile->ty;
+    const sparse_tile* n = findTile(map, tx, ty - 1);
+    const sparse_tile* s = findTile(map, tx, ty + 1);
+    const sparse_tile* w = findTile(map, tx - 1, ty);
+    const sparse_tile* e = findTile(map, tx + 1, ty);
+    const sparse_tile* nw = findTile(map, tx - 1, ty - 1);
+    const sparse_tile* ne = findTile(map, tx + 1, ty - 1);
+    const sparse_tile* sw = findTile(map, tx - 1, ty + 1);
+    const sparse_tile* se = findTile(map, tx + 1, ty + 1);
+    uint64_t mid[SPARSE_TILE + 2], lft[SPARSE_TILE + 2], rgt[SPARSE_TILE + 2];
+    uint64_t live = 0;
+    unsigned int r;
+
+    memcpy(mid + 1, tile->rows, sizeof(tile->rows));
+    mid[0] = n ? n->rows[SPARSE_TILE - 1] : 0;
+    mid[SPARSE_TILE + 1] = s ? s->rows[0] : 0;
+
+    lft[0] = nw ? nw->rows[SPARSE_TILE - 1] >> 63 : 0;
+    rgt[0] = ne ? ne->rows[SPARSE_TILE - 1] & 1 : 0;
+    lft[SPARSE_TILE + 1] = sw ? sw->rows[0] >> 63 : 0;
+    rgt[SPARSE_TILE + 1] = se ? se->rows[0] & 1 : 0;
+
+    for (r = 0; r < SPARSE_TILE; r++) {
+        lft[r + 1] = w ? w->rows[r] >> 63 : 0;
+        rgt[r + 1] = e ? e->rows[r] & 1 : 0;
+    }
+
+    for (r = 1; r <= SPARSE_TILE; r++) {
+
+        uint64_t a = mid[r - 1], c = mid[r], b = mid[r + 1];
+
+        tile->next[r - 1] = lifeWord(
+            (a << 1) | lft[r - 1], a, (a >> 1) | (rgt[r - 1] << 63),
+            (c << 1) | lft[r],     c, (c >> 1) | (rgt[r] << 63),
+            (b << 1) | lft[r + 1], b, (b >> 1) | (rgt[r + 1] << 63));
+        live |= tile->next[r - 1];
+    }
+
+    return live != 0;
+}
+
+void Sparse_NextGeneration(sparse_map* map) {
+
+    size_t i, count = map->tile_count;
+    sparse_tile* tile;
+
+    // Tiles added here start empty and cannot grow further this generation
+    for (i = 0; i < count; i++) {
+        growTile(map, map->tiles[i]);
+    }
+
+    for (i = 0; i < map->tile_count; i++) {
+        tile = map->tiles[i];
+        tile->idle = stepTile(map, tile) ? 0 : tile->idle + 1;
+    }
+
+    // Walk backwards, removeTile moves the last tile into the freed place
+    for (i = map->tile_count; i-- > 0;) {
+        tile = map->tiles[i];
+        memcpy(tile->rows, tile->next, sizeof(tile->rows));
+        if (tile->idle > SPARSE_IDLE) removeTile(map, tile);
+    }
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameSparse(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    sparse_map map;
+
+    Sparse_Init(&map, width, height);
+    life106_read_file_sparse(input_field_filename, &map);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        Sparse_NextGeneration(&map);
+    }
+
+    clock_t end = clock();
+
+    printf("// Sparse tiles: %zu allocated, %zu at peak\n", map.tile_count, map.peak_tiles);
+
+    life106_save_file_sparse(output_field_filename, &map);
+
+    Sparse_Release(&map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+#define SPARSE_TILE         64      // cells per tile side, one word per row
+
+/*
+* 64x64 cells of the unbounded plane, bit i of rows[r] is cell
+* (64 * tx + i, 64 * ty + r). Tiles only exist where the pattern is.
+*/
+typedef struct {
+    int32_t tx;
+    int32_t ty;
+    unsigned int index;             // position in sparse_map.tiles
+    unsigned int idle;              // generations without a live cell
+    uint64_t rows[SPARSE_TILE];
+    uint64_t next[SPARSE_TILE];
+} sparse_tile;
+
+/*
+* Open addressing hash map from tile coordinate to tile. The tiles are
+* additionally kept in a dense array so a generation can walk them
+* without touching the empty slots.
+*/
+typedef struct {
+    int offset_x;                   // plane coordinate of the Life 1.06 origin
+    int offset_y;
+    sparse_tile** slots;
+    size_t slot_count;              // power of two
+    sparse_tile** tiles;
+    size_t tile_count;
+    size_t tile_capacity;
+    size_t peak_tiles;
+} sparse_map;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameSparse(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
+void Sparse_Init(sparse_map* map, unsigned width, unsigned height);
+void Sparse_Release(sparse_map* map);
+void Sparse_SetCell(sparse_map* map, int64_t x, int64_t y);
+void Sparse_NextGeneration(sparse_map* map);
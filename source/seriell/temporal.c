@@ -0,0 +1,202 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Temporal blocking on the bitboard layout: a tile of a band of rows is
+* copied together with TEMPORAL_STEPS ghost rows above and below and one
+* ghost word left and right into a cache-sized buffer and advanced several
+* generations there. The valid region shrinks by one row and one column per
+* generation, so after k generations exactly the tile is left and the field
+* is streamed once per k generations. Tiling in x keeps the buffer in the
+* cache however wide the field is.
+*
+* Referenzen:
+* Temporal blocking: https://en.wikipedia.org/wiki/Loop_tiling
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "temporal.h"
+#include "bitboard.h"
+#include "mem_optimized.h"
+#include "life106.h"
+
+#define TEMPORAL_STEPS          8               // generations per pass over the field, at most 64
+#define TEMPORAL_CACHE_BYTES    (256 * 1024)    // both tile buffers together
+#define TEMPORAL_TILE_WORDS     128             // field words per tile row
+
+/*
+* A buffer row is pad, left ghost word, up to tile_words words of the
+* field, right ghost word, pad. The row kernel only reads the pads; what
+* they spoil in the ghost words moves one cell per generation and never
+* reaches the tile within 64 generations.
+*/
+typedef struct {
+    unsigned int band;          // rows per band
+    unsigned int steps;         // ghost rows on each side
+    unsigned int tile_words;    // field words per tile
+    unsigned int stride;        // tile_words + 4
+    uint64_t* src;
+    uint64_t* dst;
+} band_buffer;
+
+static void bandInit(band_buffer* buf, const bitmap* map, unsigned int steps) {
+
+    size_t row_bytes, fit, rows;
+
+    buf->tile_words = (map->words < TEMPORAL_TILE_WORDS) ? map->words : TEMPORAL_TILE_WORDS;
+    buf->stride = buf->tile_words + 4;
+
+    row_bytes = (size_t)buf->stride * sizeof(uint64_t);
+    fit = TEMPORAL_CACHE_BYTES / (2 * row_bytes);
+
+    // Fewer generations per pass while the ghost rows outweigh the band, down to plain steps
+    while (steps > 1 && fit < 4 * (size_t)steps) steps /= 2;
+    buf->steps = steps;
+
+    // At least one band row even if the ghost rows alone fill the cache
+    buf->band = (fit > 2 * steps) ? (unsigned int)(fit - 2 * steps) : 1;
+    if (buf->band > map->height) buf->band = map->height;
+
+    rows = buf->band + 2 * (size_t)steps;
+    buf->src = (uint64_t*)xmalloc(rows * row_bytes);
+    buf->dst = (uint64_t*)xmalloc(rows * row_bytes);
+    memset(buf->src, 0, rows * row_bytes);
+    memset(buf->dst, 0, rows * row_bytes);
+}
+
+static void bandRelease(band_buffer* buf) {
+    free(buf->src);
+    free(buf->dst);
+}
+
+/*
+* n <= 64 cells of a field row starting at x < w, wrapped around the torus.
+* row points at word 0; bits behind the last cell are zero.
+*/
+static uint64_t fetchBits(const uint64_t* row, unsigned int w, unsigned int x, unsigned int n) {
+
+    unsigned int i = x >> 6, shift = x & 63;
+    unsigned int take = (w - x < n) ? w - x : n;
+    uint64_t bits = row[i] >> shift;
+
+    if (shift + take > 64) bits |= row[i + 1] << (64 - shift);
+    if (take < 64) bits &= ((uint64_t)1 << take) - 1;
+    if (take < n) bits |= fetchBits(row, w, 0, n - take) << take;
+
+    return bits;
+}
+
+/*
+* Buffer row of the tile of words t0 .. t0 + tw - 1. Local cell j is field
+* cell x0 - 64 + j around the torus, also past a partial last word.
+*/
+static void loadTileRow(const bitmap* map, uint64_t* local, const uint64_t* row, unsigned int t0, unsigned int tw) {
+
+    unsigned int w = map->width, words = map->words;
+    unsigned int x0 = t0 << 6, x1 = (t0 + tw) << 6;
+
+    memcpy(local + 2, row + t0, tw * sizeof(uint64_t));
+
+    // A partial last word continues with the first cells of the row
+    if ((w & 63) && t0 + tw == words) local[tw + 1] = fetchBits(row, w, (words - 1) << 6, 64);
+
+    local[1] = fetchBits(row, w, (x0 >= 64) ? x0 - 64 : (w - 64 % w) % w, 64);
+    local[tw + 2] = fetchBits(row, w, x1 % w, 64);
+}
+
+/*
+* Advance the tile of words t0 .. t0 + tw - 1 of rows y0 .. y0 + rows - 1
+* by steps generations. Local row i holds field row y0 - steps + i
+* (mod h); rows may repeat when the field is smaller than the buffer, which
+* still gives the torus result. The tile is then written into
+* map->temp_rows.
+*/
+static void advanceTile(bitmap* map, band_buffer* buf, unsigned int y0, unsigned int rows, unsigned int t0, unsigned int tw, unsigned int steps) {
+
+    unsigned int i, g, n = rows + 2 * steps;
+    unsigned int h = map->height, stride = buf->stride;
+    unsigned int first = (unsigned int)(((long long)y0 - steps) % h + h) % h;
+    uint64_t* src = buf->src;
+    uint64_t* dst = buf->dst;
+    uint64_t* out;
+    uint64_t* temp;
+
+    for (i = 0; i < n; i++) {
+        loadTileRow(map, src + (size_t)i * stride, map->rows + (size_t)((first + i) % h) * map->stride + 1, t0, tw);
+    }
+
+    for (g = 1; g <= steps; g++) {
+
+        for (i = g; i < n - g; i++) {
+            bitboardRowKernel(src + (size_t)(i - 1) * stride, src + (size_t)i * stride, src + (size_t)(i + 1) * stride,
+                dst + (size_t)i * stride, tw + 2, ~(uint64_t)0);
+        }
+
+        temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    for (i = steps; i < n - steps; i++) {
+        out = map->temp_rows + (size_t)(y0 + i - steps) * map->stride + 1 + t0;
+        memcpy(out, src + (size_t)i * stride + 2, tw * sizeof(uint64_t));
+        if (t0 + tw == map->words) out[tw - 1] &= map->last_mask;
+    }
+}
+
+static void nextGenerationsTemporal(bitmap* map, band_buffer* buf, unsigned int steps) {
+
+    unsigned int y0, rows, t0, tw;
+    uint64_t* temp;
+
+    for (y0 = 0; y0 < map->height; y0 += buf->band) {
+        rows = (map->height - y0 < buf->band) ? map->height - y0 : buf->band;
+        for (t0 = 0; t0 < map->words; t0 += tw) {
+            tw = (map->words - t0 < buf->tile_words) ? map->words - t0 : buf->tile_words;
+            advanceTile(map, buf, y0, rows, t0, tw, steps);
+        }
+    }
+
+    temp = map->rows;
+    map->rows = map->temp_rows;
+    map->temp_rows = temp;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameTemporal(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    bitmap map = BitMap_Init(width, height);
+    band_buffer buf;
+    unsigned int done, steps;
+
+    life106_read_file_bitmap(input_field_filename, &map);
+    bandInit(&buf, &map, TEMPORAL_STEPS);
+
+    clock_t start = clock();
+
+    for (done = 0; done < frames; done += steps) {
+        steps = (frames - done < buf.steps) ? frames - done : buf.steps;
+        nextGenerationsTemporal(&map, &buf, steps);
+    }
+
+    clock_t end = clock();
+
+    life106_save_file_bitmap(output_field_filename, &map);
+
+    bandRelease(&buf);
+    BitMap_Release(map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+// 
+// =================================================
+
+double GameTemporal(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
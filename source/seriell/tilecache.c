@@ -0,0 +1,205 @@
+/********************************************************************
+*
+* Titel : HPC Game Of Life
+* Author: Dimitri Dening
+* Date  : 25.04.2021
+*
+* Tile cache on the bitboard layout: the next generation of a 16x16 tile
+* only depends on the tile and its one-cell border. Repeating textures
+* (agar, periodic backgrounds) hit the same 18x18 keys over and over, so
+* the interior is looked up in a set-associative LRU cache and only
+* computed on a miss. Tiles without a live cell skip the cache.
+*
+* Referenzen:
+* Bitboard:   https://www.chessprogramming.org/General_Setwise_Operations
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* User defined headers */
+#include "tilecache.h"
+#include "bitboard.h"
+#include "mem_optimized.h"
+#include "life106.h"
+
+#define KEY_ROWS    (TILE_CACHE_SIDE + 2)
+#define KEY_MASK    ((1u << KEY_ROWS) - 1)
+
+static void tileCacheInit(tile_cache* cache) {
+
+    size_t entries = (size_t)TILE_CACHE_SETS * TILE_CACHE_WAYS;
+
+    cache->entries = (tile_entry*)xmalloc(entries * sizeof(tile_entry));
+    cache->used = (unsigned char*)xmalloc(TILE_CACHE_SETS);
+    memset(cache->used, 0, TILE_CACHE_SETS);
+
+    cache->lookups = 0;
+    cache->hits = 0;
+    cache->empty = 0;
+}
+
+static void tileCacheRelease(tile_cache* cache) {
+    free(cache->entries);
+    free(cache->used);
+}
+
+static inline uint64_t hashKey(const uint32_t* key) {
+
+    uint64_t h = 0;
+
+    for (unsigned int i = 0; i < KEY_ROWS; i++) {
+        h = (h ^ key[i]) * 0x9E3779B97F4A7C15ull;
+    }
+
+    return h ^ (h >> 32);
+}
+
+// 18 bits of a wrapped row starting at cell x - 1
+static inline uint32_t keyRow(const uint64_t* row, unsigned int x) {
+
+    unsigned int bit = x + 63;      // row[0] is the ghost word
+    unsigned int shift = bit & 63;
+    uint64_t lo = row[bit >> 6], hi = row[(bit >> 6) + 1];
+    uint64_t window = shift ? (lo >> shift) | (hi << (64 - shift)) : lo;
+
+    return (uint32_t)window & KEY_MASK;
+}
+
+// Next generation of the tile interior, bit i of next[r] is cell (x + i, y + r)
+static void computeTile(const uint32_t* key, uint16_t* next) {
+
+    for (unsigned int r = 0; r < TILE_CACHE_SIDE; r++) {
+
+        uint64_t a = key[r], c = key[r + 1], b = key[r + 2];
+        uint64_t out = lifeWord(a << 1, a, a >> 1, c << 1, c, c >> 1, b << 1, b, b >> 1);
+
+        next[r] = (uint16_t)(out >> 1);
+    }
+}
+
+/*
+* Return the cached next generation of key, computing and inserting it on
+* a miss. A hit moves the entry to the front of its set, a miss drops the
+* least recently used way.
+*/
+static const uint16_t* lookupTile(tile_cache* cache, const uint32_t* key) {
+
+    uint64_t hash = hashKey(key);
+    size_t set = (size_t)(hash & (TILE_CACHE_SETS - 1));
+    tile_entry* ways = cache->entries + set * TILE_CACHE_WAYS;
+    unsigned int used = cache->used[set];
+    unsigned int i;
+    tile_entry found;
+
+    cache->lookups++;
+
+    for (i = 0; i < used; i++) {
+        if (ways[i].hash == hash && memcmp(ways[i].key, key, sizeof(ways[i].key)) == 0) break;
+    }
+
+    if (i < used) {
+        cache->hits++;
+        if (i == 0) return ways[0].next;
+        found = ways[i];
+    }
+    else {
+        found.hash = hash;
+        memcpy(found.key, key, sizeof(found.key));
+        computeTile(key, found.next);
+        if (used < TILE_CACHE_WAYS) cache->used[set] = (unsigned char)++used;
+        i = used - 1;
+    }
+
+    memmove(ways + 1, ways, i * sizeof(tile_entry));
+    ways[0] = found;
+
+    return ways[0].next;
+}
+
+static void nextGenerationTileCache(bitmap* map, tile_cache* cache) {
+
+    unsigned int x, y, r, ty, live, h = map->height, stride = map->stride;
+    unsigned int columns = map->words * (64 / TILE_CACHE_SIDE);
+    uint64_t* rows = map->rows;
+    uint64_t* out;
+    uint64_t* temp;
+    uint32_t key[KEY_ROWS];
+    const uint16_t* next;
+    static const uint16_t zero[TILE_CACHE_SIDE] = { 0 };
+
+    for (y = 0; y < h; y++) {
+        wrapRow(rows + (size_t)y * stride, map->width, map->words);
+    }
+
+    for (ty = 0; ty < h; ty += TILE_CACHE_SIDE) {
+        for (x = 0; x < columns * TILE_CACHE_SIDE; x += TILE_CACHE_SIDE) {
+
+            // Key rows ty - 1 .. ty + 16 on the torus, rows past the field
+            // only feed output rows that are never written
+            live = 0;
+            for (r = 0; r < KEY_ROWS; r++) {
+                y = (ty + h - 1 + r) % h;
+                key[r] = keyRow(rows + (size_t)y * stride, x);
+                live |= key[r];
+            }
+
+            if (live) {
+                next = lookupTile(cache, key);
+            }
+            else {
+                next = zero;
+                cache->empty++;
+            }
+
+            for (r = 0; r < TILE_CACHE_SIDE && ty + r < h; r++) {
+                out = map->temp_rows + (size_t)(ty + r) * stride + 1 + (x >> 6);
+                *out &= ~((uint64_t)0xFFFF << (x & 63));
+                *out |= (uint64_t)next[r] << (x & 63);
+            }
+        }
+    }
+
+    for (y = 0; y < h; y++) {
+        map->temp_rows[(size_t)y * stride + map->words] &= map->last_mask;
+    }
+
+    temp = map->rows;
+    map->rows = map->temp_rows;
+    map->temp_rows = temp;
+}
+
+// =================================================
+//
+//                  GAME OF LIFE
+//
+// =================================================
+
+double GameTileCache(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename) {
+
+    bitmap map = BitMap_Init(width, height);
+    tile_cache cache;
+
+    tileCacheInit(&cache);
+    life106_read_file_bitmap(input_field_filename, &map);
+
+    clock_t start = clock();
+
+    for (unsigned int i = 0; i < frames; i++) {
+        nextGenerationTileCache(&map, &cache);
+    }
+
+    clock_t end = clock();
+
+    printf("// Tile cache: %llu lookups, %.1f%% hits, %llu empty tiles\n",
+        cache.lookups, cache.lookups ? 100.0 * cache.hits / cache.lookups : 0.0, cache.empty);
+
+    life106_save_file_bitmap(output_field_filename, &map);
+
+    tileCacheRelease(&cache);
+    BitMap_Release(map);
+
+    return (double)(end - start) / (double)CLOCKS_PER_SEC;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+// =================================================
+//
+//                  STRUCTURES
+//
+// =================================================
+
+#define TILE_CACHE_SIDE     16          // tile is 16x16 cells, the key 18x18
+#define TILE_CACHE_WAYS     4           // entries per set, most recent first
+#define TILE_CACHE_SETS     (1 << 14)   // 64K entries, about 7 MB
+
+/*
+* One cached transition: the 18 rows of 18 bits around a tile and the 16
+* rows of its next generation.
+*/
+typedef struct {
+    uint64_t hash;
+    uint32_t key[TILE_CACHE_SIDE + 2];
+    uint16_t next[TILE_CACHE_SIDE];
+} tile_entry;
+
+typedef struct {
+    tile_entry* entries;        // TILE_CACHE_SETS * TILE_CACHE_WAYS
+    unsigned char* used;        // valid ways per set
+    unsigned long long lookups;
+    unsigned long long hits;
+    unsigned long long empty;   // tiles without a live cell in the key
+} tile_cache;
+
+// =================================================
+//
+//              FUNCTION PROTOTYPES
+//
+// =================================================
+
+double GameTileCache(unsigned width, unsigned height, unsigned frames, char* input_field_filename, char* output_field_filename);
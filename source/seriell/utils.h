@@ -1,6 +1,24 @@
 #pragma once
 
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #define for_i(i, length) for (unsigned i = 0; i < (length); i++)
 #define for_yx(height, width) for_i(y, height) for_i(x, width)
 
 void error(char* message);
+
+// Index of the lowest set bit, v must not be 0
+static inline unsigned ctz64(uint64_t v)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, v);
+	return (unsigned)index;
+#else
+	return (unsigned)__builtin_ctzll(v);
+#endif
+}